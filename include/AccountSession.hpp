@@ -0,0 +1,86 @@
+#ifndef ACCOUNT_SESSION_HPP
+#define ACCOUNT_SESSION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/asio.hpp>
+#include <nlohmann/json.hpp>
+#include "AsyncRestClient.hpp"
+#include "SharedRuntime.hpp"
+
+// One authenticated account (or subaccount) attached to a SharedRuntime. A
+// session owns only its token, its open orders and positions and a small REST
+// connection pool; threads, SSL and market data come from the runtime, so a
+// dozen subaccounts cost a dozen tokens rather than a dozen clients. Tokens are
+// refreshed on the runtime before they expire; a failed refresh is retried
+// with exponential backoff and reported to the refresh listener. Always held
+// by shared_ptr.
+class AccountSession : public std::enable_shared_from_this<AccountSession> {
+public:
+    using Handler = AsyncRestClient::Handler;
+
+private:
+    SharedRuntime& _runtime;
+    std::string _name, _clientId, _clientSecret;
+    AsyncRestClient _rest;
+    // The refresh timer is only touched from handlers on _strand.
+    boost::asio::strand<boost::asio::io_context::executor_type> _strand;
+    boost::asio::steady_timer _refreshTimer;
+    std::atomic<uint64_t> _nextRequestId{1};
+
+    static constexpr std::chrono::seconds max_refresh_backoff{60};
+
+    mutable std::mutex _mutex;
+    std::string _refreshToken;
+    bool _authenticated = false;
+    std::chrono::steady_clock::time_point _tokenExpiry;
+    int _refreshFailures = 0;
+    Handler _refreshListener;
+    std::unordered_multimap<std::string, std::string> _openOrders;
+    nlohmann::json _positions = nlohmann::json::array();
+
+    // Every REST request goes through here; the session and the handler are
+    // never released inside the AsyncRestClient handler itself.
+    void call(const std::string& method, nlohmann::json params, Handler handler);
+    void authenticateWith(const std::string& method, nlohmann::json params, Handler handler);
+    void scheduleRefresh(std::chrono::steady_clock::duration delay);
+    void refresh();
+
+public:
+    AccountSession(SharedRuntime& runtime, std::string name, std::string client_id, std::string client_secret, size_t connections = 2);
+    ~AccountSession();
+
+    AccountSession(const AccountSession&) = delete;
+    AccountSession& operator=(const AccountSession&) = delete;
+
+    // public/auth with the session's client credentials.
+    void authenticate(Handler handler);
+
+    // Opens a session for one of this account's subaccounts via public/exchange_token.
+    // This session must be authenticated; the new one is once the handler reports success.
+    std::shared_ptr<AccountSession> openSubaccount(std::string name, int64_t subject_id, Handler handler);
+
+    void placeOrder(const std::string& instrument_name, double amount, double price, const std::string& order_type, Handler handler);
+    void cancelOrder(const std::string& order_id, Handler handler);
+    void modifyOrder(const std::string& order_id, double amount, double price, Handler handler);
+    void refreshPositions(Handler handler);
+
+    // Called on the runtime after each background token refresh attempt, with
+    // the error when it failed.
+    void setRefreshListener(Handler listener);
+
+    const std::string& name() const { return _name; }
+    // True while the session holds an unexpired access token.
+    bool authenticated() const;
+    std::vector<std::pair<std::string, std::string>> openOrders() const;
+    nlohmann::json positions() const;
+};
+
+#endif // ACCOUNT_SESSION_HPP
@@ -0,0 +1,123 @@
+#ifndef ASYNC_REST_CLIENT_HPP
+#define ASYNC_REST_CLIENT_HPP
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include "TlsSessionCache.hpp"
+
+// Non-blocking JSON-RPC over HTTPS. Requests are spread over a small pool of
+// keep-alive connections, each driven by its own strand on the caller's
+// io_context, so any number of requests can be outstanding without a thread
+// per request. Handlers run on the io_context. A request that fails on a
+// reused keep-alive connection before any response bytes arrive (the server
+// closed it while idle) is resent once on a fresh connection.
+//
+// Destroying the client closes every connection and waits for handlers that
+// are already running; requests still outstanding are dropped without their
+// handlers being called. Do not destroy it from one of its own handlers.
+class AsyncRestClient {
+public:
+    using Handler = std::function<void(boost::system::error_code, nlohmann::json)>;
+
+private:
+    struct PendingRequest {
+        std::string target;
+        std::string body;
+        Handler handler;
+        bool sent = false;
+        bool resent = false;
+    };
+
+    // Everything connections need from their owner. Connections hold it by
+    // shared_ptr so io handlers that outlive the client never touch freed
+    // memory; `closed` (under `lifetime`) tells them the owner is gone.
+    struct Shared {
+        boost::asio::ssl::context& ssl_context;
+        std::string host, port;
+        TlsSessionCache* session_cache = nullptr;
+        std::atomic<int64_t> in_flight{0};
+        std::atomic<int64_t> queued{0};
+
+        mutable std::mutex token_mutex;
+        std::string access_token;
+
+        std::shared_mutex lifetime;
+        bool closed = false;
+
+        Shared(boost::asio::ssl::context& context, const std::string& host_name, const std::string& port_name)
+            : ssl_context(context), host(host_name), port(port_name)
+        {
+        }
+
+        std::string accessToken() const;
+    };
+
+    class Connection : public std::enable_shared_from_this<Connection> {
+    private:
+        std::shared_ptr<Shared> _shared;
+        boost::asio::strand<boost::asio::io_context::executor_type> _strand;
+        boost::asio::ip::tcp::resolver _resolver;
+        std::unique_ptr<boost::beast::ssl_stream<boost::beast::tcp_stream>> _stream;
+        boost::beast::flat_buffer _buffer;
+        boost::beast::http::request<boost::beast::http::string_body> _request;
+        boost::beast::http::response<boost::beast::http::string_body> _response;
+        std::deque<PendingRequest> _queue;
+        std::chrono::steady_clock::time_point _sentAt;
+        bool _busy = false;
+        bool _connected = false;
+        size_t _requestsOnConnection = 0;
+
+        // Every strand entry point holds this for its duration. Returns an
+        // unlocked guard, after dropping all work, once the owner is closed.
+        std::shared_lock<std::shared_mutex> lockOwner();
+        void abandon();
+        void next();
+        void connect();
+        void send();
+        // Resends the front request on a new connection if the current one went stale.
+        bool resendOnStale(boost::system::error_code ec);
+        void complete(boost::system::error_code ec);
+
+    public:
+        Connection(std::shared_ptr<Shared> shared, boost::asio::io_context& io_context);
+
+        void enqueue(PendingRequest request);
+        void close();
+        size_t depth() const { return _queue.size(); }
+    };
+
+    boost::asio::io_context& _io_context;
+    std::shared_ptr<Shared> _shared;
+    std::vector<std::shared_ptr<Connection>> _connections;
+    std::atomic<size_t> _nextConnection{0};
+
+public:
+    AsyncRestClient(boost::asio::io_context& io_context, boost::asio::ssl::context& ssl_context,
+                    const std::string& host, const std::string& port, size_t connections = 4);
+    ~AsyncRestClient();
+
+    AsyncRestClient(const AsyncRestClient&) = delete;
+    AsyncRestClient& operator=(const AsyncRestClient&) = delete;
+
+    void request(const std::string& target, std::string body, Handler handler);
+    void setAccessToken(const std::string& token);
+    // Resume TLS sessions from a cache attached to the same SSL context. Set before the first request.
+    void setSessionCache(TlsSessionCache* cache) { _shared->session_cache = cache; }
+
+    boost::asio::io_context& context() { return _io_context; }
+    int64_t inFlight() const { return _shared->in_flight.load(std::memory_order_relaxed); }
+};
+
+#endif // ASYNC_REST_CLIENT_HPP
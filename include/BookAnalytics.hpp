@@ -0,0 +1,98 @@
+#ifndef BOOK_ANALYTICS_HPP
+#define BOOK_ANALYTICS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "OrderBook.hpp"
+#include "SeqLock.hpp"
+
+// Derived top-of-book metrics for one instrument, published as one unit.
+struct BookMetrics {
+    int64_t timestamp = 0;
+    uint64_t change_id = 0;
+    uint64_t updates = 0;
+
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    double best_bid_amount = 0.0;
+    double best_ask_amount = 0.0;
+    double spread = 0.0;
+    double mid = 0.0;
+    double microprice = 0.0;       // best prices weighted by the opposite side's size
+
+    double bid_depth = 0.0;        // size over the top N levels
+    double ask_depth = 0.0;
+    double depth_imbalance = 0.0;  // (bid_depth - ask_depth) / (bid_depth + ask_depth)
+
+    double bid_pressure = 0.0;     // top N size weighted 1 / (level + 1)
+    double ask_pressure = 0.0;
+    double book_pressure = 0.0;    // (bid_pressure - ask_pressure) / (bid_pressure + ask_pressure)
+};
+
+// Keeps BookMetrics current as book deltas arrive. Each side's top N levels are
+// held in contiguous arrays with running depth and pressure sums: a size change
+// at a level already in the window adjusts the sums in place, changes outside
+// the window are skipped, and only inserts or deletes inside it refill the
+// window from the book and recompute it in one vectorisable pass. Every
+// resum_interval in-place updates a side is refilled from the book anyway, so
+// floating-point drift in the running sums stays bounded. One writer (the
+// market data thread); any number of readers via snapshot().
+class BookAnalytics {
+public:
+    static constexpr size_t max_instruments = 256;
+    static constexpr size_t depth = BookTop::max_depth;
+    static constexpr uint32_t resum_interval = 1024;
+
+private:
+    static constexpr size_t padded_depth = (depth + 3) / 4 * 4;
+
+    struct Side {
+        alignas(32) double prices[padded_depth] = {};
+        alignas(32) double amounts[padded_depth] = {};
+        size_t count = 0;
+        double size = 0.0;
+        double pressure = 0.0;
+        uint32_t in_place_updates = 0;
+    };
+
+    struct Slot {
+        Side bids;
+        Side asks;
+        uint64_t updates = 0;
+        SeqLock<BookMetrics> metrics;
+        std::string instrument_name;
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<size_t> _instrumentCount{0};
+    std::unordered_map<std::string, size_t> _instrumentIndex;
+    std::mutex _registrationMutex;
+
+    template <typename Levels>
+    static void refill(Side& side, const Levels& levels);
+    template <typename Levels>
+    static void applySide(Side& side, const std::vector<BookLevelChange>& changes, const Levels& levels, bool bids);
+    static void recompute(Side& side);
+    static bool applyChanges(Side& side, const std::vector<BookLevelChange>& changes, bool bids);
+    void publish(Slot& slot, const OrderBook& book);
+
+public:
+    BookAnalytics();
+
+    int registerInstrument(const std::string& instrument_name);
+    int findInstrument(const std::string& instrument_name);
+    size_t instrumentCount() const { return _instrumentCount.load(std::memory_order_acquire); }
+
+    // Call after the delta has been applied to the book.
+    void apply(size_t instrument_index, const BookUpdate& update, const OrderBook& book);
+    // Full recompute, e.g. after a snapshot resync or when the book is cleared.
+    void rebuild(size_t instrument_index, const OrderBook& book);
+
+    bool snapshot(size_t instrument_index, BookMetrics& out) const;
+};
+
+#endif // BOOK_ANALYTICS_HPP
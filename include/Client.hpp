@@ -14,6 +14,19 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <thread>
+#include <mutex>
+#include <string_view>
+#include "MessageArena.hpp"
+#include "OrderBook.hpp"
+#include "MarketDataConflator.hpp"
+#include "BookAnalytics.hpp"
+#include "ShmBookPublisher.hpp"
+#include "Trade.hpp"
+#include "AsyncRestClient.hpp"
+#include "TradeTape.hpp"
+#include "PaperExchange.hpp"
+#include "OrderAmendmentQueue.hpp"
+#include "SharedRuntime.hpp"
 
 class Client {
 private:
@@ -26,25 +39,140 @@ private:
     std::atomic<bool> is_running;
 
     std::string _host, _port, _clientId, _secreatKey, _accessToken;
+    // Guards _accessToken: rest_auth writes it while other startup phases send requests.
+    std::mutex _tokenMutex;
 
-    std::unordered_map<std::string, std::string> payload_cache;
+    // Payloads are shared immutable strings so a caller keeps its payload alive
+    // even if another thread evicts it; the map and LRU list need _cacheMutex.
+    std::mutex _cacheMutex;
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> payload_cache;
+    // Guards openOrders and order_history.json: async completions store orders from io threads.
+    std::mutex _ordersMutex;
     std::unordered_multimap<std::string, std::string> openOrders;
     std::list<std::string> cache_keys;
     
     static constexpr size_t max_cache_size = 100;
     static constexpr size_t max_payload_size = 500;
 
-    void addToCache(const std::string& key, const std::string& payload);
-    std::string getFromCache(const std::string& key);
+    using Payload = std::shared_ptr<const std::string>;
+
+    void addToCache(const std::string& key, const Payload& payload);
+    Payload getFromCache(const std::string& key);
+    Payload cachedRequest(const std::string& endpoint, const std::string& method, std::string_view params);
     boost::asio::ssl::context _ssl_context_ws;
     boost::asio::io_context _io_context_ws;
     boost::beast::websocket::stream<boost::asio::ssl::stream<boost::asio::ip::tcp::socket>> _ws;
 
+    struct InstrumentState {
+        OrderBook book;
+        int conflatorSlot = -1;
+        int shmSlot = -1;
+        int tapeSlot = -1;
+        int analyticsSlot = -1;
+        bool resyncing = false;
+        std::vector<BookUpdate> pendingDeltas;
+    };
+
+    static constexpr size_t max_snapshot_depth = 10000;
+    static constexpr size_t max_buffered_deltas = 10000;
+
+    std::unordered_map<std::string, InstrumentState> _instruments;
+    BookUpdate _bookUpdate;
+    BookTop _bookTop;
+    MarketDataConflator _conflator;
+    TradeTape _tradeTape;
+    BookAnalytics _analytics;
+    std::unique_ptr<ShmBookPublisher> _shmPublisher;
+    std::unordered_map<uint64_t, std::string> _pendingSnapshots;
+    uint64_t _nextRequestId = 1000;
+    std::unique_ptr<AsyncRestClient> _asyncRest;
+    std::shared_ptr<PaperExchange> _paperExchange;
+    std::ofstream _recording;
+    OrderAmendmentQueue _amendments;
+
+    // Guards ssl_stream: requests, connect() and the ping thread's reconnects.
+    std::mutex _restMutex;
+    std::mutex _endpointMutex;
+    boost::asio::ip::tcp::resolver::results_type _endpoints;
+    std::atomic<bool> _restConnected{false};
+    std::string _instrumentName;
+
+    const std::string& sendRaw(const std::string& endpoint, const std::string& method, std::string_view payload);
+    const std::string& sendOrderRequest(const std::string& endpoint, const std::string& payload);
+    static ArenaJson parseArenaResponse(std::string_view body);
+    template <typename Json>
+    void storeOrderFrom(const Json& orderResponse);
+
+    void handleMarketDataMessage(std::string_view message);
+    void handleBookNotification(const ArenaJson& data);
+    void handleBookSnapshot(const std::string& instrument_name, const ArenaJson& response);
+    void handleTradeNotification(const ArenaJson& data);
+    void requestBookSnapshot(const std::string& instrument_name);
+    void bufferBookDelta(InstrumentState& state, const BookUpdate& update);
+    size_t bufferedBookDeltas() const;
+    void publishBook(InstrumentState& state, uint32_t changes);
+
+    // Both send an already serialized JSON-RPC body as is.
+    void startRequest(const std::string& endpoint, std::string payload, AsyncRestClient::Handler handler);
+    void startOrderRequest(const std::string& endpoint, const Payload& payload, AsyncRestClient::Handler handler);
+    void startPlaceOrder(const std::string& instrument_name, double amount, double price, const std::string& order_type, AsyncRestClient::Handler handler);
+    void startCancelOrder(const std::string& order_id, AsyncRestClient::Handler handler);
+    void startModifyOrder(const std::string& order_id, double amount, double price, AsyncRestClient::Handler handler);
+    void startGetOrderBook(const std::string& instrument_name, AsyncRestClient::Handler handler);
+    void startViewCurrentPositions(AsyncRestClient::Handler handler);
+
+    // Adapts an asio completion token (callback, use_future, use_awaitable, ...)
+    // to the std::function handlers used by AsyncRestClient. Completions that
+    // arrive while start() is still running (no io_context attached, paper
+    // venue) are posted, so no token completes inside its async*() call.
+    template <typename CompletionToken, typename Start>
+    static auto initiateAsync(CompletionToken&& token, Start start)
+    {
+        return boost::asio::async_initiate<CompletionToken, void(boost::system::error_code, nlohmann::json)>(
+            [start = std::move(start)](auto handler) mutable {
+                auto shared = std::make_shared<std::decay_t<decltype(handler)>>(std::move(handler));
+                auto initiating = std::make_shared<std::atomic<bool>>(true);
+                start([shared, initiating](boost::system::error_code ec, nlohmann::json response) {
+                    auto executor = boost::asio::get_associated_executor(*shared);
+                    auto complete = [shared, ec, response = std::move(response)]() mutable {
+                        (*shared)(ec, std::move(response));
+                    };
+
+                    if (initiating->load(std::memory_order_acquire))
+                    {
+                        boost::asio::post(executor, std::move(complete));
+                    }
+                    else
+                    {
+                        boost::asio::dispatch(executor, std::move(complete));
+                    }
+                });
+                initiating->store(false, std::memory_order_release);
+            },
+            token);
+    }
+    InstrumentState& instrumentState(const std::string& instrument_name);
+    boost::asio::ip::tcp::resolver::results_type endpoints();
+
+public:
+    struct InstrumentInfo {
+        std::string kind;
+        double tick_size = 0.0;
+        double min_trade_amount = 0.0;
+        double contract_size = 0.0;
+    };
+
+private:
+    mutable std::mutex _instrumentInfoMutex;
+    std::unordered_map<std::string, InstrumentInfo> _instrumentInfo;
 
 public:
     Client(const std::string& host, const std::string& port, const std::string& clientId, const std::string& secreatKey);
     ~Client();
     
+    // Startup steps, safe to run concurrently: REST and WebSocket share one DNS
+    // lookup, and each side connects and authenticates on its own socket.
+    void resolve();
     void connect();
     void authenticate();
     nlohmann::json sendRequest(const std::string& endpoint, const std::string& method, const nlohmann::json& payload);
@@ -53,6 +181,7 @@ public:
     void logLatency(const std::chrono::duration<double>& duration);
     void setAccessToken(std::string &token);
 
+    // Start pinging only once startup has finished; a failed ping reconnects.
     void pingServer();
     void startPing();
     void stopPing();
@@ -66,14 +195,92 @@ public:
     void getOrderBook(const std::string& instrument_name);
     void viewCurrentPositions();
 
+    // Routes placeOrder/modifyOrder/cancelOrder (and their async variants) to a
+    // local simulator fed from the live stream. Pass nullptr to go live again.
+    void enablePaperTrading(std::shared_ptr<PaperExchange> exchange);
+
+    // Non-blocking amend/cancel through the per-order amendment queue: one
+    // request in flight per order, later amendments collapse to the latest
+    // price/amount. Requires attachAsync() or paper trading.
+    void queueModifyOrder(const std::string& order_id, double amount, double price);
+    void queueCancelOrder(const std::string& order_id);
+    OrderAmendmentQueue& amendments();
+    void recordMarketData(const std::string& path);
+
     void initWebSocket();
+    void connectWebSocket();
+    void authenticateWebSocket();
+    // public/get_instruments for one currency; throws if the request fails.
+    void loadInstruments(const std::string& currency);
+    bool instrumentInfo(const std::string& instrument_name, InstrumentInfo& out) const;
     void subscribeToMarketData(const std::string& symbol);
+    void subscribeToTrades(const std::string& symbol);
     void streamMarketData(const int &seconds);
+    MarketDataConflator& conflator();
+    TradeTape& tradeTape();
+    // Spread, mid, microprice, depth imbalance and book pressure per instrument,
+    // updated on every applied book message.
+    BookAnalytics& analytics();
+    void enableSharedMemoryPublisher(const std::string& segment_name);
 
     static const nlohmann::json payload;
     bool _wsConnected;
 
     nlohmann::json getCachedPayload(const std::string& endpoint, const std::string& method, const nlohmann::json& params);
+
+    // Asynchronous variants. Requests run on the attached io_context and
+    // complete with (error_code, json); any asio completion token works.
+    void attachAsync(boost::asio::io_context& io_context, size_t connections = 4);
+    // Same, on a shared runtime's io threads, SSL context and TLS session cache.
+    void attachRuntime(SharedRuntime& runtime, size_t connections = 4);
+
+    template <typename CompletionToken>
+    auto asyncSendRequest(const std::string& endpoint, const nlohmann::json& payload, CompletionToken&& token)
+    {
+        return initiateAsync(std::forward<CompletionToken>(token), [this, endpoint, payload](AsyncRestClient::Handler handler) {
+            startRequest(endpoint, payload.dump(), std::move(handler));
+        });
+    }
+
+    template <typename CompletionToken>
+    auto asyncPlaceOrder(const std::string& instrument_name, double amount, double price, const std::string& order_type, CompletionToken&& token)
+    {
+        return initiateAsync(std::forward<CompletionToken>(token), [this, instrument_name, amount, price, order_type](AsyncRestClient::Handler handler) {
+            startPlaceOrder(instrument_name, amount, price, order_type, std::move(handler));
+        });
+    }
+
+    template <typename CompletionToken>
+    auto asyncCancelOrder(const std::string& order_id, CompletionToken&& token)
+    {
+        return initiateAsync(std::forward<CompletionToken>(token), [this, order_id](AsyncRestClient::Handler handler) {
+            startCancelOrder(order_id, std::move(handler));
+        });
+    }
+
+    template <typename CompletionToken>
+    auto asyncModifyOrder(const std::string& order_id, double amount, double price, CompletionToken&& token)
+    {
+        return initiateAsync(std::forward<CompletionToken>(token), [this, order_id, amount, price](AsyncRestClient::Handler handler) {
+            startModifyOrder(order_id, amount, price, std::move(handler));
+        });
+    }
+
+    template <typename CompletionToken>
+    auto asyncGetOrderBook(const std::string& instrument_name, CompletionToken&& token)
+    {
+        return initiateAsync(std::forward<CompletionToken>(token), [this, instrument_name](AsyncRestClient::Handler handler) {
+            startGetOrderBook(instrument_name, std::move(handler));
+        });
+    }
+
+    template <typename CompletionToken>
+    auto asyncViewCurrentPositions(CompletionToken&& token)
+    {
+        return initiateAsync(std::forward<CompletionToken>(token), [this](AsyncRestClient::Handler handler) {
+            startViewCurrentPositions(std::move(handler));
+        });
+    }
 };
 
 
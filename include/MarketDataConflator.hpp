@@ -0,0 +1,76 @@
+#ifndef MARKET_DATA_CONFLATOR_HPP
+#define MARKET_DATA_CONFLATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "OrderBook.hpp"
+#include "SeqLock.hpp"
+
+// Collapses book updates per instrument for consumers that cannot keep up with
+// the raw feed. The producer overwrites the latest top-N state and flags it as
+// dirty for every registered consumer; a consumer's poll costs
+// O(instruments) no matter how many messages arrived since its last read.
+class MarketDataConflator {
+public:
+    static constexpr size_t max_instruments = 256;
+    static constexpr size_t max_consumers = 16;
+
+    enum ChangeFlags : uint32_t {
+        BidsChanged = 1u << 0,
+        AsksChanged = 1u << 1,
+        Resynced = 1u << 2
+    };
+
+    struct ConflatedUpdate {
+        size_t instrument_index;
+        const std::string* instrument_name;
+        uint32_t changes;
+        uint64_t updates_conflated;
+        BookTop top;
+    };
+
+private:
+    static constexpr size_t bitmap_words = max_instruments / 64;
+
+    struct Slot {
+        SeqLock<BookTop> book;
+        std::atomic<uint64_t> publish_count{0};
+        std::string instrument_name;
+    };
+
+    struct Consumer {
+        std::atomic<bool> active{false};
+        std::array<std::atomic<uint64_t>, bitmap_words> dirty{};
+        std::array<std::atomic<uint32_t>, max_instruments> changes{};
+        std::array<uint64_t, max_instruments> last_count{};
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    std::unique_ptr<Consumer[]> _consumers;
+    std::atomic<size_t> _instrumentCount{0};
+    std::unordered_map<std::string, size_t> _instrumentIndex;
+    std::mutex _registrationMutex;
+
+public:
+    MarketDataConflator();
+
+    int registerInstrument(const std::string& instrument_name);
+    int findInstrument(const std::string& instrument_name);
+    size_t instrumentCount() const { return _instrumentCount.load(std::memory_order_acquire); }
+
+    int registerConsumer();
+    void unregisterConsumer(int consumer_id);
+    size_t activeConsumers() const;
+
+    void publish(size_t instrument_index, const BookTop& top, uint32_t changes);
+    size_t poll(int consumer_id, std::vector<ConflatedUpdate>& out);
+    bool latest(size_t instrument_index, BookTop& out) const;
+};
+
+#endif // MARKET_DATA_CONFLATOR_HPP
@@ -0,0 +1,15 @@
+#ifndef MARKET_DATA_PARSER_HPP
+#define MARKET_DATA_PARSER_HPP
+
+#include "MessageArena.hpp"
+#include "OrderBook.hpp"
+#include "Trade.hpp"
+
+// Decoders from Deribit JSON into the plain structs the market data components
+// work on, shared by the live client and the paper exchange replay. Input is
+// arena-backed so a message is decoded without per-node heap allocations.
+void parseBookNotification(const ArenaJson& data, BookUpdate& out);
+void parseBookSnapshot(const std::string& instrument_name, const ArenaJson& result, BookUpdate& out);
+Trade parseTrade(const ArenaJson& print);
+
+#endif // MARKET_DATA_PARSER_HPP
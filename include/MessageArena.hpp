@@ -0,0 +1,113 @@
+#ifndef MESSAGE_ARENA_HPP
+#define MESSAGE_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Thread-local monotonic arena for per-message scratch allocations. Memory is
+// bump-allocated from retained chunks and released all at once by reset(), so
+// once the chunks have grown to the working-set size, handling a message does
+// no global malloc/free.
+class MessageArena {
+public:
+    static constexpr size_t chunk_size = 64 * 1024;
+
+private:
+    struct Chunk {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t size;
+    };
+
+    std::vector<Chunk> _chunks;
+    size_t _current = 0;
+    size_t _offset = 0;
+
+    void* allocateSlow(size_t bytes, size_t alignment);
+
+public:
+    static MessageArena& local();
+
+    void* allocate(size_t bytes, size_t alignment)
+    {
+        if (!_chunks.empty())
+        {
+            Chunk& chunk = _chunks[_current];
+            size_t aligned = (_offset + alignment - 1) & ~(alignment - 1);
+            if (aligned + bytes <= chunk.size)
+            {
+                _offset = aligned + bytes;
+                return chunk.memory.get() + aligned;
+            }
+        }
+        return allocateSlow(bytes, alignment);
+    }
+
+    void reset()
+    {
+        _current = 0;
+        _offset = 0;
+    }
+
+    size_t reserved() const;
+};
+
+// Resets the calling thread's arena when the outermost scope ends. Declare it
+// before any arena-backed object in the same block so those die first.
+class ArenaScope {
+private:
+    static thread_local int _depth;
+
+public:
+    ArenaScope() { ++_depth; }
+    ~ArenaScope()
+    {
+        if (--_depth == 0)
+        {
+            MessageArena::local().reset();
+        }
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+// Stateless allocator over the thread's MessageArena; deallocation is a no-op.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(MessageArena::local().allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept
+    {
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const noexcept { return false; }
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// nlohmann::json whose nodes, strings and containers all live in the arena.
+// Instances must not outlive the ArenaScope they were created in.
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t, double, ArenaAllocator>;
+
+#endif // MESSAGE_ARENA_HPP
@@ -0,0 +1,116 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+enum class Counter : size_t {
+    RestRequests,
+    RestErrors,
+    WsMessages,
+    WsBytes,
+    OrdersPlaced,
+    OrdersCancelled,
+    OrdersModified,
+    OrderErrors,
+    Reconnects,
+    CacheHits,
+    CacheMisses,
+    ConflatedUpdates,
+    BookGaps,
+    BookResyncs,
+    AmendmentsCoalesced,
+    AmendmentsDropped,
+    TlsSessionsResumed,
+    AnalyticsRecomputes,
+    TokenRefreshFailures,
+    Count
+};
+
+enum class Gauge : size_t {
+    TrackedInstruments,
+    OpenOrders,
+    ConflationConsumers,
+    BufferedBookDeltas,
+    AsyncRequestsInFlight,
+    AccountSessions,
+    PublicChannels,
+    WsWriteQueueDepth,
+    RestQueueDepth,
+    Count
+};
+
+enum class Histogram : size_t {
+    RestLatency,
+    MarketDataProcessing,
+    Count
+};
+
+// Process-wide metrics. Counters and histograms are sharded per thread: the hot
+// path only touches its own cache lines with plain relaxed stores, and shards
+// are summed when the endpoint is scraped.
+class Metrics {
+public:
+    // Log-scale latency buckets: 1us * 2^i, the last bucket is +Inf.
+    static constexpr size_t histogram_buckets = 26;
+
+private:
+    struct HistogramShard {
+        std::array<std::atomic<uint64_t>, histogram_buckets> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum_ns{0};
+    };
+
+    struct alignas(64) ThreadShard {
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)> counters{};
+        std::array<HistogramShard, static_cast<size_t>(Histogram::Count)> histograms;
+    };
+
+    std::mutex _shardsMutex;
+    std::vector<std::shared_ptr<ThreadShard>> _shards;
+    std::array<std::atomic<int64_t>, static_cast<size_t>(Gauge::Count)> _gauges{};
+
+    static Metrics& instance();
+    static ThreadShard& localShard();
+
+public:
+    static void increment(Counter counter, uint64_t value = 1);
+    static void setGauge(Gauge gauge, int64_t value);
+    static void observe(Histogram histogram, std::chrono::nanoseconds duration);
+
+    static std::string renderPrometheus();
+};
+
+// Serves Metrics::renderPrometheus() on http://127.0.0.1:<port>/metrics from
+// its own thread. Connections are handled asynchronously and closed if the
+// request does not arrive within request_timeout, so an idle or slow client
+// cannot stall scrapes.
+class MetricsServer {
+private:
+    static constexpr std::chrono::seconds request_timeout{5};
+
+    boost::asio::io_context _io_context;
+    boost::asio::ip::tcp::acceptor _acceptor;
+    std::thread _thread;
+
+    void accept();
+    void serve(boost::asio::ip::tcp::socket socket);
+
+public:
+    explicit MetricsServer(unsigned short port);
+    ~MetricsServer();
+
+    void start();
+    void stop();
+};
+
+#endif // METRICS_HPP
@@ -0,0 +1,71 @@
+#ifndef ORDER_AMENDMENT_QUEUE_HPP
+#define ORDER_AMENDMENT_QUEUE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <boost/system/error_code.hpp>
+#include <nlohmann/json.hpp>
+
+// Keeps at most one edit or cancel in flight per order. Amendments made while
+// one is outstanding collapse into the latest price/amount, and a pending
+// cancel discards any amendment queued behind it. Orders whose cancel
+// succeeded are remembered (the most recent max_cancelled of them), so later
+// amendments or cancels for them are dropped instead of sent.
+class OrderAmendmentQueue {
+public:
+    static constexpr size_t max_cancelled = 4096;
+
+public:
+    using Completion = std::function<void(boost::system::error_code, nlohmann::json)>;
+    using EditSender = std::function<void(const std::string& order_id, double amount, double price, Completion completion)>;
+    using CancelSender = std::function<void(const std::string& order_id, Completion completion)>;
+    using Listener = std::function<void(const std::string& order_id, boost::system::error_code ec, const nlohmann::json& response)>;
+
+private:
+    struct OrderSlot {
+        bool in_flight = false;
+        bool amend_pending = false;
+        bool cancel_pending = false;
+        bool cancel_sent = false;
+        double amount = 0.0;
+        double price = 0.0;
+    };
+
+    enum class Action { None, Edit, Cancel };
+
+    struct Dispatch {
+        Action action = Action::None;
+        std::string order_id;
+        double amount = 0.0;
+        double price = 0.0;
+    };
+
+    EditSender _sendEdit;
+    CancelSender _sendCancel;
+    Listener _listener;
+    std::mutex _mutex;
+    std::unordered_map<std::string, OrderSlot> _orders;
+    std::unordered_set<std::string> _cancelled;
+    std::deque<std::string> _cancelledOrder;   // oldest first, for eviction
+
+    Dispatch next(const std::string& order_id, OrderSlot& slot);
+    void rememberCancelled(const std::string& order_id);
+    void send(const Dispatch& dispatch);
+    void complete(const std::string& order_id, bool was_cancel, boost::system::error_code ec, const nlohmann::json& response);
+
+public:
+    OrderAmendmentQueue(EditSender send_edit, CancelSender send_cancel);
+
+    void amend(const std::string& order_id, double amount, double price);
+    void cancel(const std::string& order_id);
+
+    void setListener(Listener listener);
+    size_t trackedOrders();
+};
+
+#endif // ORDER_AMENDMENT_QUEUE_HPP
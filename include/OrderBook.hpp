@@ -0,0 +1,73 @@
+#ifndef ORDER_BOOK_HPP
+#define ORDER_BOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+struct BookLevelChange {
+    enum class Action : uint8_t { New, Change, Delete };
+
+    Action action;
+    double price;
+    double amount;
+};
+
+// One decoded `book.<instrument>.raw` notification.
+struct BookUpdate {
+    std::string instrument_name;
+    int64_t timestamp = 0;
+    uint64_t change_id = 0;
+    uint64_t prev_change_id = 0;
+    bool is_snapshot = false;
+    std::vector<BookLevelChange> bids;
+    std::vector<BookLevelChange> asks;
+
+    void clear();
+};
+
+// Fixed-size top-of-book view, trivially copyable so it can be handed across
+// threads and processes by value.
+struct BookTop {
+    static constexpr size_t max_depth = 10;
+
+    int64_t timestamp;
+    uint64_t change_id;
+    uint32_t bid_count;
+    uint32_t ask_count;
+    double bid_prices[max_depth];
+    double bid_amounts[max_depth];
+    double ask_prices[max_depth];
+    double ask_amounts[max_depth];
+};
+
+class OrderBook {
+public:
+    using BidSide = std::map<double, double, std::greater<double>>;
+    using AskSide = std::map<double, double>;
+
+private:
+    BidSide _bids;
+    AskSide _asks;
+    uint64_t _changeId = 0;
+    int64_t _timestamp = 0;
+
+public:
+    void apply(const BookUpdate& update);
+    void clear();
+    void fillTop(BookTop& top) const;
+
+    uint64_t changeId() const { return _changeId; }
+    int64_t timestamp() const { return _timestamp; }
+    bool empty() const { return _bids.empty() && _asks.empty(); }
+
+    const BidSide& bids() const { return _bids; }
+    const AskSide& asks() const { return _asks; }
+    double bidAmount(double price) const;
+    double askAmount(double price) const;
+};
+
+#endif // ORDER_BOOK_HPP
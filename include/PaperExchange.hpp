@@ -0,0 +1,94 @@
+#ifndef PAPER_EXCHANGE_HPP
+#define PAPER_EXCHANGE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "OrderBook.hpp"
+#include "Trade.hpp"
+
+// Simulated execution venue. It answers the same private/buy, private/sell,
+// private/edit and private/cancel JSON-RPC calls as Deribit, and matches
+// resting orders against the book and trade stream it is fed. Fed either live
+// by Client or from a recording through replay().
+//
+// Queue model: a resting order joins the back of its price level. Each trade
+// print is shared out once across the resting orders it reaches, in
+// price-time priority; at the print's price it consumes the queue ahead of
+// our orders before filling them. Level size reductions not explained by
+// trades are treated as cancellations spread pro-rata across the queue.
+class PaperExchange {
+public:
+    using Listener = std::function<void(const nlohmann::json& notification)>;
+    using BookListener = std::function<void(const std::string& instrument_name, const OrderBook& book)>;
+
+private:
+    struct SimOrder {
+        std::string order_id;
+        std::string instrument_name;
+        std::string order_type;
+        int direction;
+        double price;
+        double amount;
+        double filled = 0.0;
+        double average_price = 0.0;
+        double queue_ahead = 0.0;
+        // Time priority within a level; renewed when an edit loses priority.
+        uint64_t priority = 0;
+        std::string state = "open";
+        int64_t creation_timestamp = 0;
+        int64_t last_update_timestamp = 0;
+    };
+
+    // Volume printed per resting level since the last book update, keyed by
+    // instrument then (side, price). Lets onBook tell trades from cancels.
+    using LevelTrades = std::map<std::pair<int, double>, double>;
+
+    mutable std::recursive_mutex _mutex;
+    std::unordered_map<std::string, OrderBook> _books;
+    std::unordered_map<std::string, SimOrder> _orders;
+    std::unordered_map<std::string, LevelTrades> _tradedAtLevel;
+    Listener _listener;
+    BookListener _bookListener;
+    uint64_t _nextOrderId = 1;
+    uint64_t _nextTradeId = 1;
+    uint64_t _nextPriority = 1;
+    int64_t _now = 0;
+    BookUpdate _replayUpdate;
+    std::vector<nlohmann::json> _notifications;
+
+    nlohmann::json place(int direction, const nlohmann::json& params);
+    nlohmann::json edit(const nlohmann::json& params);
+    nlohmann::json cancel(const nlohmann::json& params);
+    nlohmann::json openOrdersLocked(const std::string& instrument_name) const;
+
+    void matchAggressive(SimOrder& order, nlohmann::json& trades);
+    void fill(SimOrder& order, double amount, double price, const char* liquidity, nlohmann::json& trades);
+    void checkCrossed(const std::string& instrument_name);
+    void notifyOrder(const SimOrder& order, const nlohmann::json& trades);
+    void flushNotifications();
+
+    static nlohmann::json orderJson(const SimOrder& order);
+    static nlohmann::json error(const nlohmann::json& id, int code, const std::string& message);
+
+public:
+    nlohmann::json handleRequest(const nlohmann::json& payload);
+
+    void onBook(const BookUpdate& update);
+    void onTrade(const std::string& instrument_name, const Trade& trade);
+
+    // Feeds a recording made with Client::recordMarketData. speed is a multiple
+    // of real time; 0 replays as fast as possible. Returns messages replayed.
+    size_t replay(const std::string& path, double speed = 0.0);
+
+    void setOrderListener(Listener listener);
+    void setBookListener(BookListener listener);
+    nlohmann::json openOrders(const std::string& instrument_name = "") const;
+};
+
+#endif // PAPER_EXCHANGE_HPP
@@ -0,0 +1,88 @@
+#ifndef PUBLIC_MARKET_DATA_FEED_HPP
+#define PUBLIC_MARKET_DATA_FEED_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include "TlsSessionCache.hpp"
+
+// One public WebSocket shared by every account in the process. Each channel
+// (book.*, trades.*, ticker.* ...) is subscribed on the exchange once, however
+// many listeners ask for it, and the subscription set is replayed after a
+// reconnect. Listeners run on the runtime's io threads, serialised by the feed's
+// strand, and get the raw notification; it is only valid during the call.
+class PublicMarketDataFeed {
+public:
+    using Listener = std::function<void(std::string_view channel, std::string_view message)>;
+
+private:
+    using WebSocket = boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>>;
+
+    struct Subscriber {
+        uint64_t id;
+        std::shared_ptr<const Listener> listener;
+    };
+
+    boost::asio::io_context& _io_context;
+    boost::asio::ssl::context& _ssl_context;
+    TlsSessionCache& _sessionCache;
+    std::string _host, _port;
+
+    // Touched only on the strand.
+    boost::asio::strand<boost::asio::io_context::executor_type> _strand;
+    boost::asio::ip::tcp::resolver _resolver;
+    boost::asio::steady_timer _retryTimer;
+    std::unique_ptr<WebSocket> _ws;
+    boost::beast::flat_buffer _buffer;
+    std::deque<std::string> _writes;
+    std::vector<std::shared_ptr<const Listener>> _dispatch;
+    std::string _channel;
+    bool _running = false;
+    bool _connected = false;
+    bool _writing = false;
+    uint64_t _generation = 0;
+    uint64_t _nextRequestId = 1;
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, std::vector<Subscriber>> _channels;
+    std::unordered_map<uint64_t, std::string> _subscriptions;
+    uint64_t _nextSubscription = 1;
+
+    void connect();
+    void fail(uint64_t generation, const char* what, boost::system::error_code ec);
+    void scheduleReconnect();
+    void read();
+    void write(std::string message);
+    void flush();
+    void sendSubscription(const char* method, const std::vector<std::string>& channels);
+    void dispatch(std::string_view message);
+
+public:
+    PublicMarketDataFeed(boost::asio::io_context& io_context, boost::asio::ssl::context& ssl_context,
+                         TlsSessionCache& session_cache, const std::string& host, const std::string& port);
+
+    PublicMarketDataFeed(const PublicMarketDataFeed&) = delete;
+    PublicMarketDataFeed& operator=(const PublicMarketDataFeed&) = delete;
+
+    void start();
+    void stop();
+
+    // Returns a handle for unsubscribe(). The first listener on a channel subscribes it on the exchange.
+    uint64_t subscribe(const std::string& channel, Listener listener);
+    void unsubscribe(uint64_t subscription);
+
+    size_t channelCount() const;
+};
+
+#endif // PUBLIC_MARKET_DATA_FEED_HPP
@@ -0,0 +1,71 @@
+#ifndef SEQ_LOCK_HPP
+#define SEQ_LOCK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <thread>
+
+// Single-writer sequence lock. The writer never blocks; readers retry until they
+// observe an even, unchanged sequence around their copy.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+private:
+    alignas(64) std::atomic<uint64_t> _seq{0};
+    T _value{};
+
+public:
+    void store(const T& value)
+    {
+        uint64_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&_value, &value, sizeof(T));
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    bool tryLoad(T& out) const
+    {
+        uint64_t before = _seq.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            return false;
+        }
+
+        std::memcpy(&out, &_value, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return before == _seq.load(std::memory_order_relaxed);
+    }
+
+    // Bounded retry for readers that must never block, e.g. in another process
+    // where the writer may die with the sequence left odd.
+    bool tryLoad(T& out, int attempts) const
+    {
+        for (int i = 0; i < attempts; ++i)
+        {
+            if (tryLoad(out))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void load(T& out) const
+    {
+        while (!tryLoad(out))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t sequence() const
+    {
+        return _seq.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SEQ_LOCK_HPP
@@ -0,0 +1,49 @@
+#ifndef SHARED_RUNTIME_HPP
+#define SHARED_RUNTIME_HPP
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include "PublicMarketDataFeed.hpp"
+#include "TlsSessionCache.hpp"
+
+// I/O runtime shared by every account in the process: one io_context run by a
+// pool sized to the machine rather than to the number of accounts, one SSL
+// context with a client session cache, and one public market data feed.
+// AccountSessions and Clients attach to it; they must be destroyed before it.
+class SharedRuntime {
+private:
+    std::string _host, _port;
+    size_t _threadCount;
+    boost::asio::io_context _io_context;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> _work;
+    boost::asio::ssl::context _ssl_context;
+    TlsSessionCache _sessionCache;
+    std::unique_ptr<PublicMarketDataFeed> _marketData;
+    std::vector<std::thread> _threads;
+
+public:
+    // threads == 0 uses one io thread per hardware thread.
+    SharedRuntime(const std::string& host, const std::string& port, size_t threads = 0);
+    ~SharedRuntime();
+
+    SharedRuntime(const SharedRuntime&) = delete;
+    SharedRuntime& operator=(const SharedRuntime&) = delete;
+
+    void start();
+    void stop();
+
+    boost::asio::io_context& context() { return _io_context; }
+    boost::asio::ssl::context& sslContext() { return _ssl_context; }
+    TlsSessionCache& sessionCache() { return _sessionCache; }
+    PublicMarketDataFeed& marketData() { return *_marketData; }
+
+    const std::string& host() const { return _host; }
+    const std::string& port() const { return _port; }
+    size_t threadCount() const { return _threadCount; }
+};
+
+#endif // SHARED_RUNTIME_HPP
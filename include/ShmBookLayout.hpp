@@ -0,0 +1,59 @@
+#ifndef SHM_BOOK_LAYOUT_HPP
+#define SHM_BOOK_LAYOUT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "OrderBook.hpp"
+#include "SeqLock.hpp"
+#include "Trade.hpp"
+
+// Memory layout shared by ShmBookPublisher and ShmBookReader. The segment is a
+// header followed by `max_instruments` fixed slots; each slot carries the
+// instrument's top-N book and last trade behind their own seqlocks, so readers
+// in other processes never take a lock or make a syscall.
+//
+// `generation` changes when the publisher retires the segment (shutdown or a
+// new publisher replacing a stale one); readers holding the old mapping see
+// the change and reopen by name.
+struct ShmBookHeader {
+    static constexpr uint64_t magic_value = 0x4452425453484D31ull; // "DRBTSHM1"
+    static constexpr uint32_t layout_version = 2;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t max_instruments;
+    uint32_t depth;
+    uint32_t slot_size;
+    int32_t publisher_pid;
+    alignas(64) std::atomic<uint64_t> generation;
+    std::atomic<uint32_t> instrument_count;
+};
+
+struct ShmBookSlot {
+    static constexpr size_t max_name_length = 64;
+
+    char instrument_name[max_name_length];
+    SeqLock<BookTop> book;
+    SeqLock<Trade> last_trade;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory seqlocks require lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared-memory header requires lock-free 32-bit atomics");
+
+inline size_t shmBookSegmentSize(size_t max_instruments)
+{
+    return sizeof(ShmBookHeader) + max_instruments * sizeof(ShmBookSlot);
+}
+
+inline ShmBookSlot* shmBookSlots(void* base)
+{
+    return reinterpret_cast<ShmBookSlot*>(static_cast<char*>(base) + sizeof(ShmBookHeader));
+}
+
+inline const ShmBookSlot* shmBookSlots(const void* base)
+{
+    return reinterpret_cast<const ShmBookSlot*>(static_cast<const char*>(base) + sizeof(ShmBookHeader));
+}
+
+#endif // SHM_BOOK_LAYOUT_HPP
@@ -0,0 +1,39 @@
+#ifndef SHM_BOOK_PUBLISHER_HPP
+#define SHM_BOOK_PUBLISHER_HPP
+
+#include <string>
+#include <unordered_map>
+#include "ShmBookLayout.hpp"
+
+// Owns a POSIX shared-memory segment and publishes each instrument's top-N book
+// and last trade into it. Single writer; see ShmBookReader for the read side.
+// Refuses to start while another live publisher owns the segment name; a
+// segment left behind by a dead publisher is retired and recreated.
+class ShmBookPublisher {
+private:
+    std::string _segmentName;
+    size_t _maxInstruments;
+    size_t _segmentSize;
+    int _fd;
+    void* _base;
+    ShmBookHeader* _header;
+    ShmBookSlot* _slots;
+    std::unordered_map<std::string, int> _instrumentIndex;
+
+    uint64_t retireStaleSegment();
+
+public:
+    explicit ShmBookPublisher(const std::string& segment_name, size_t max_instruments = 256);
+    ~ShmBookPublisher();
+
+    ShmBookPublisher(const ShmBookPublisher&) = delete;
+    ShmBookPublisher& operator=(const ShmBookPublisher&) = delete;
+
+    int registerInstrument(const std::string& instrument_name);
+    void publishBook(int slot, const BookTop& top);
+    void publishTrade(int slot, const Trade& trade);
+
+    const std::string& segmentName() const { return _segmentName; }
+};
+
+#endif // SHM_BOOK_PUBLISHER_HPP
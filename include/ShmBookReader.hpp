@@ -0,0 +1,40 @@
+#ifndef SHM_BOOK_READER_HPP
+#define SHM_BOOK_READER_HPP
+
+#include <string>
+#include "ShmBookLayout.hpp"
+
+// Read side of the shared-memory book segment for other processes on the host.
+// Opening maps the segment read-only; every read afterwards is a plain seqlock
+// copy out of the mapping. Reads never block: a slot the publisher is writing
+// (or died while writing) is retried a bounded number of times and then
+// reported as unavailable.
+class ShmBookReader {
+private:
+    static constexpr int max_read_attempts = 64;
+
+    size_t _segmentSize;
+    uint64_t _generation;
+    void* _base;
+    const ShmBookHeader* _header;
+    const ShmBookSlot* _slots;
+
+public:
+    explicit ShmBookReader(const std::string& segment_name);
+    ~ShmBookReader();
+
+    ShmBookReader(const ShmBookReader&) = delete;
+    ShmBookReader& operator=(const ShmBookReader&) = delete;
+
+    size_t instrumentCount() const;
+    int findInstrument(const std::string& instrument_name) const;
+    const char* instrumentName(int slot) const;
+
+    // True once the publisher has retired this segment; reopen by name to follow it.
+    bool stale() const;
+
+    bool readBook(int slot, BookTop& out) const;
+    bool readTrade(int slot, Trade& out) const;
+};
+
+#endif // SHM_BOOK_READER_HPP
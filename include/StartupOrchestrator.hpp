@@ -0,0 +1,52 @@
+#ifndef STARTUP_ORCHESTRATOR_HPP
+#define STARTUP_ORCHESTRATOR_HPP
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Runs startup phases as a dependency graph: every phase starts on its own
+// thread as soon as the phases it depends on have finished, so independent
+// work (DNS, handshakes, history recovery, metadata) overlaps. The first
+// failure stops anything not yet started; run() waits for phases already in
+// flight, logs the timing breakdown and rethrows.
+class StartupOrchestrator {
+public:
+    enum class State { Pending, Running, Done, Failed, Skipped };
+
+    struct PhaseTiming {
+        std::string name;
+        State state;
+        std::chrono::nanoseconds started;   // offset from run()
+        std::chrono::nanoseconds duration;
+        std::string error;
+    };
+
+private:
+    struct Phase {
+        std::string name;
+        std::function<void()> run;
+        std::vector<size_t> dependencies;
+        State state = State::Pending;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point finished;
+        std::string error;
+    };
+
+    std::vector<Phase> _phases;
+    std::chrono::steady_clock::time_point _started;
+    std::chrono::steady_clock::time_point _finished;
+
+public:
+    // Dependencies must name phases added earlier.
+    void addPhase(const std::string& name, std::function<void()> run, const std::vector<std::string>& dependencies = {});
+
+    void run();
+
+    std::vector<PhaseTiming> timings() const;
+    std::chrono::nanoseconds elapsed() const { return _finished - _started; }
+    void report() const;
+};
+
+#endif // STARTUP_ORCHESTRATOR_HPP
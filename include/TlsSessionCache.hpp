@@ -0,0 +1,37 @@
+#ifndef TLS_SESSION_CACHE_HPP
+#define TLS_SESSION_CACHE_HPP
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <boost/asio/ssl.hpp>
+
+// Client-side TLS session cache shared by every connection made from one SSL
+// context. Sessions are keyed by SNI host name, so reconnects and additional
+// pooled connections to the same host resume instead of running a full
+// handshake.
+class TlsSessionCache {
+private:
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, SSL_SESSION*> _sessions;
+
+    static int onNewSession(SSL* ssl, SSL_SESSION* session);
+
+public:
+    TlsSessionCache() = default;
+    ~TlsSessionCache();
+
+    TlsSessionCache(const TlsSessionCache&) = delete;
+    TlsSessionCache& operator=(const TlsSessionCache&) = delete;
+
+    // Installs the new-session callback on the context. The cache must outlive it.
+    void attach(boost::asio::ssl::context& context);
+
+    // Offers the cached session for the SSL object's SNI host, if any. Call after
+    // SSL_set_tlsext_host_name and before the handshake.
+    void resume(SSL* ssl);
+
+    size_t size() const;
+};
+
+#endif // TLS_SESSION_CACHE_HPP
@@ -0,0 +1,17 @@
+#ifndef TRADE_HPP
+#define TRADE_HPP
+
+#include <cstdint>
+
+// One decoded `trades.<instrument>.raw` print.
+struct Trade {
+    enum Direction : int8_t { Sell = -1, Buy = 1 };
+
+    int64_t timestamp;
+    double price;
+    double amount;
+    int8_t direction;
+    uint64_t trade_id;
+};
+
+#endif // TRADE_HPP
@@ -0,0 +1,89 @@
+#ifndef TRADE_TAPE_HPP
+#define TRADE_TAPE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Trade.hpp"
+
+// Per-instrument trade history in preallocated columnar rings. Each column is
+// its own contiguous array, so time-range queries binary-search the timestamp
+// column and the aggregate kernels stream over price/amount/direction only.
+//
+// append() is single-writer and lock-free: it fills the columns and then
+// publishes the new head with a release store. Readers run concurrently,
+// treat the oldest slot as the one the writer may be overwriting, and retry
+// when the writer laps the range they read. Rings are only allocated for
+// instruments registered through registerInstrument().
+class TradeTape {
+public:
+    static constexpr size_t max_instruments = 256;
+
+    struct Aggregates {
+        size_t trades = 0;
+        double volume = 0.0;
+        double notional = 0.0;
+        double buy_volume = 0.0;
+        double sell_volume = 0.0;
+        double vwap = 0.0;
+        // (buy - sell) / (buy + sell), in [-1, 1].
+        double imbalance = 0.0;
+    };
+
+private:
+    struct Ring {
+        std::vector<int64_t> timestamps;
+        std::vector<double> prices;
+        std::vector<double> amounts;
+        std::vector<int8_t> directions;
+        std::vector<uint64_t> trade_ids;
+        alignas(64) std::atomic<uint64_t> head{0};
+
+        explicit Ring(size_t capacity);
+    };
+
+    static constexpr int max_read_attempts = 16;
+
+    size_t _capacity;
+    size_t _mask;
+    std::array<std::unique_ptr<Ring>, max_instruments> _rings;
+    std::atomic<size_t> _ringCount{0};
+    std::unordered_map<std::string, size_t> _instrumentIndex;
+    mutable std::shared_mutex _registrationMutex;
+
+    const Ring* ring(int instrument) const;
+    // Oldest logical position readers may use while the head is `head`.
+    uint64_t oldest(uint64_t head) const;
+    // Logical positions [first, last) of trades with from <= timestamp < to.
+    void range(const Ring& ring, uint64_t head, int64_t from, int64_t to, uint64_t& first, uint64_t& last) const;
+    // True if the writer has not overwritten position `first` since the read began.
+    bool stillValid(const Ring& ring, uint64_t first) const;
+
+public:
+    explicit TradeTape(size_t capacity_per_instrument = 1 << 16);
+
+    int registerInstrument(const std::string& instrument_name);
+    int findInstrument(const std::string& instrument_name) const;
+
+    // Single writer per tape (the market data thread).
+    void append(int instrument, const Trade& trade);
+
+    // Trades currently queryable; one less than capacity once the ring wraps.
+    size_t size(int instrument) const;
+    size_t capacity() const { return _capacity; }
+
+    size_t query(int instrument, int64_t from, int64_t to, std::vector<Trade>& out) const;
+    Aggregates aggregate(int instrument, int64_t from, int64_t to) const;
+
+    double vwap(int instrument, int64_t from, int64_t to) const { return aggregate(instrument, from, to).vwap; }
+    double volume(int instrument, int64_t from, int64_t to) const { return aggregate(instrument, from, to).volume; }
+    double imbalance(int instrument, int64_t from, int64_t to) const { return aggregate(instrument, from, to).imbalance; }
+};
+
+#endif // TRADE_TAPE_HPP
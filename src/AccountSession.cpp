@@ -0,0 +1,337 @@
+#include "AccountSession.hpp"
+#include "Metrics.hpp"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+namespace
+{
+    std::atomic<int64_t> activeSessions{0};
+}
+
+AccountSession::AccountSession(SharedRuntime& runtime, std::string name, std::string client_id, std::string client_secret, size_t connections)
+    : _runtime(runtime), _name(std::move(name)), _clientId(std::move(client_id)), _clientSecret(std::move(client_secret)),
+      _rest(runtime.context(), runtime.sslContext(), runtime.host(), runtime.port(), connections),
+      _strand(boost::asio::make_strand(runtime.context())), _refreshTimer(_strand)
+{
+    _rest.setSessionCache(&runtime.sessionCache());
+    Metrics::setGauge(Gauge::AccountSessions, activeSessions.fetch_add(1, std::memory_order_relaxed) + 1);
+}
+
+AccountSession::~AccountSession()
+{
+    // Timer handlers hold a strong reference while they run, so none is running
+    // now; destroying the timer cancels the pending wait.
+    Metrics::setGauge(Gauge::AccountSessions, activeSessions.fetch_sub(1, std::memory_order_relaxed) - 1);
+}
+
+void AccountSession::call(const std::string& method, json params, Handler handler)
+{
+    json payload = {
+        {"jsonrpc", "2.0"},
+        {"id", _nextRequestId.fetch_add(1, std::memory_order_relaxed)},
+        {"method", method},
+        {"params", std::move(params)}
+    };
+
+    _rest.request("/api/v2/" + method, payload.dump(),
+        [weak = weak_from_this(), io = &_runtime.context(), handler = std::move(handler)](boost::system::error_code ec, json response) mutable {
+            // The handler may end up holding the last reference to this session.
+            // Dropping it here would destroy _rest inside one of its own handlers,
+            // so both are released from a separate io task instead.
+            auto self = weak.lock();
+            if (handler)
+            {
+                handler(ec, std::move(response));
+            }
+            boost::asio::post(*io, [self = std::move(self), handler = std::move(handler)]() {});
+        });
+}
+
+void AccountSession::authenticate(Handler handler)
+{
+    authenticateWith("public/auth", {
+        {"grant_type", "client_credentials"},
+        {"client_id", _clientId},
+        {"client_secret", _clientSecret}
+    }, std::move(handler));
+}
+
+void AccountSession::authenticateWith(const std::string& method, json params, Handler handler)
+{
+    std::weak_ptr<AccountSession> weak = weak_from_this();
+
+    call(method, std::move(params), [weak, handler = std::move(handler)](boost::system::error_code ec, json response) {
+        auto self = weak.lock();
+        if (!self)
+        {
+            return;
+        }
+
+        if (!ec && response.contains("result") && response["result"].contains("access_token"))
+        {
+            const auto& result = response["result"];
+            int64_t expiresIn = result.value("expires_in", int64_t(0));
+            self->_rest.setAccessToken(result["access_token"].get<std::string>());
+            {
+                std::lock_guard<std::mutex> lock(self->_mutex);
+                self->_refreshToken = result.value("refresh_token", std::string());
+                self->_authenticated = true;
+                self->_tokenExpiry = expiresIn > 0 ? std::chrono::steady_clock::now() + std::chrono::seconds(expiresIn)
+                                                   : std::chrono::steady_clock::time_point::max();
+                self->_refreshFailures = 0;
+            }
+
+            if (expiresIn > 0)
+            {
+                // Refresh with a tenth of the lifetime to spare so requests never go out on an expired token.
+                self->scheduleRefresh(std::chrono::seconds(std::max<int64_t>(expiresIn - expiresIn / 10, 1)));
+            }
+            spdlog::info("Account {} authenticated.", self->_name);
+        }
+        else
+        {
+            spdlog::error("Account {} authentication failed: {}", self->_name, ec ? ec.message() : response.dump());
+            if (!ec)
+            {
+                ec = boost::system::errc::make_error_code(boost::system::errc::permission_denied);
+            }
+        }
+
+        if (handler)
+        {
+            handler(ec, std::move(response));
+        }
+    });
+}
+
+void AccountSession::scheduleRefresh(std::chrono::steady_clock::duration delay)
+{
+    boost::asio::dispatch(_strand, [weak = weak_from_this(), delay]() {
+        auto self = weak.lock();
+        if (!self)
+        {
+            return;
+        }
+
+        self->_refreshTimer.expires_after(delay);
+        self->_refreshTimer.async_wait([weak](boost::system::error_code ec) {
+            auto self = weak.lock();
+            if (ec || !self)
+            {
+                return;
+            }
+
+            self->refresh();
+        });
+    });
+}
+
+void AccountSession::refresh()
+{
+    std::string refreshToken;
+    int failures = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        refreshToken = _refreshToken;
+        failures = _refreshFailures;
+    }
+
+    // Once a refresh has failed, sessions with client credentials log in from
+    // scratch in case the refresh token itself was rejected.
+    json params = failures > 0 && !_clientId.empty()
+        ? json{{"grant_type", "client_credentials"}, {"client_id", _clientId}, {"client_secret", _clientSecret}}
+        : json{{"grant_type", "refresh_token"}, {"refresh_token", refreshToken}};
+
+    authenticateWith("public/auth", std::move(params), [weak = weak_from_this()](boost::system::error_code ec, json response) {
+        auto self = weak.lock();
+        if (!self)
+        {
+            return;
+        }
+
+        Handler listener;
+        int failures = 0;
+        {
+            std::lock_guard<std::mutex> lock(self->_mutex);
+            listener = self->_refreshListener;
+            failures = ec ? ++self->_refreshFailures : 0;
+        }
+
+        if (ec)
+        {
+            // Success already rescheduled itself; a failure backs off 1s, 2s, 4s... up to a minute.
+            auto delay = std::min<std::chrono::seconds>(std::chrono::seconds(1 << std::min(failures - 1, 6)), max_refresh_backoff);
+            spdlog::error("Account {} token refresh failed (attempt {}). Retrying in {}s.", self->_name, failures, delay.count());
+            Metrics::increment(Counter::TokenRefreshFailures);
+            self->scheduleRefresh(delay);
+        }
+
+        if (listener)
+        {
+            listener(ec, std::move(response));
+        }
+    });
+}
+
+std::shared_ptr<AccountSession> AccountSession::openSubaccount(std::string name, int64_t subject_id, Handler handler)
+{
+    auto subaccount = std::make_shared<AccountSession>(_runtime, std::move(name), std::string(), std::string());
+
+    std::string refreshToken;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        refreshToken = _refreshToken;
+    }
+
+    if (refreshToken.empty())
+    {
+        spdlog::error("Cannot open subaccount {} before account {} is authenticated.", subaccount->_name, _name);
+        if (handler)
+        {
+            handler(boost::asio::error::not_connected, json());
+        }
+        return subaccount;
+    }
+
+    subaccount->authenticateWith("public/exchange_token", {
+        {"refresh_token", refreshToken},
+        {"subject_id", subject_id}
+    }, std::move(handler));
+
+    return subaccount;
+}
+
+void AccountSession::placeOrder(const std::string& instrument_name, double amount, double price, const std::string& order_type, Handler handler)
+{
+    json params = {
+        {"instrument_name", instrument_name},
+        {"amount", amount},
+        {"type", order_type}
+    };
+
+    if (order_type != "market")
+    {
+        params["price"] = price;
+    }
+
+    call("private/buy", std::move(params), [weak = weak_from_this(), handler = std::move(handler)](boost::system::error_code ec, json response) {
+        auto self = weak.lock();
+        if (self && !ec && response.contains("result"))
+        {
+            const auto& order = response["result"]["order"];
+            {
+                std::lock_guard<std::mutex> lock(self->_mutex);
+                self->_openOrders.emplace(order["instrument_name"].get<std::string>(), order["order_id"].get<std::string>());
+            }
+            Metrics::increment(Counter::OrdersPlaced);
+            spdlog::info("Account {} placed order {}", self->_name, order["order_id"].get<std::string>());
+        }
+        else
+        {
+            spdlog::error("Order placement failed: {}", ec ? ec.message() : response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
+        }
+
+        if (handler)
+        {
+            handler(ec, std::move(response));
+        }
+    });
+}
+
+void AccountSession::cancelOrder(const std::string& order_id, Handler handler)
+{
+    call("private/cancel", {{"order_id", order_id}}, [weak = weak_from_this(), order_id, handler = std::move(handler)](boost::system::error_code ec, json response) {
+        auto self = weak.lock();
+        if (self && !ec && response.contains("result"))
+        {
+            {
+                std::lock_guard<std::mutex> lock(self->_mutex);
+                for (auto it = self->_openOrders.begin(); it != self->_openOrders.end();)
+                {
+                    it = it->second == order_id ? self->_openOrders.erase(it) : std::next(it);
+                }
+            }
+            Metrics::increment(Counter::OrdersCancelled);
+        }
+        else
+        {
+            spdlog::warn("Order cancel failed : {}", ec ? ec.message() : response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
+        }
+
+        if (handler)
+        {
+            handler(ec, std::move(response));
+        }
+    });
+}
+
+void AccountSession::modifyOrder(const std::string& order_id, double amount, double price, Handler handler)
+{
+    json params = {
+        {"order_id", order_id},
+        {"amount", amount},
+        {"price", price}
+    };
+
+    call("private/edit", std::move(params), [handler = std::move(handler)](boost::system::error_code ec, json response) {
+        if (!ec && response.contains("result"))
+        {
+            Metrics::increment(Counter::OrdersModified);
+        }
+        else
+        {
+            spdlog::warn("Order modify failed : {}", ec ? ec.message() : response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
+        }
+
+        if (handler)
+        {
+            handler(ec, std::move(response));
+        }
+    });
+}
+
+void AccountSession::refreshPositions(Handler handler)
+{
+    call("private/get_positions", json::object(), [weak = weak_from_this(), handler = std::move(handler)](boost::system::error_code ec, json response) {
+        auto self = weak.lock();
+        if (self && !ec && response.contains("result"))
+        {
+            std::lock_guard<std::mutex> lock(self->_mutex);
+            self->_positions = response["result"];
+        }
+
+        if (handler)
+        {
+            handler(ec, std::move(response));
+        }
+    });
+}
+
+void AccountSession::setRefreshListener(Handler listener)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _refreshListener = std::move(listener);
+}
+
+bool AccountSession::authenticated() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _authenticated && std::chrono::steady_clock::now() < _tokenExpiry;
+}
+
+std::vector<std::pair<std::string, std::string>> AccountSession::openOrders() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::vector<std::pair<std::string, std::string>>(_openOrders.begin(), _openOrders.end());
+}
+
+json AccountSession::positions() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _positions;
+}
@@ -0,0 +1,335 @@
+#include "AsyncRestClient.hpp"
+#include "Metrics.hpp"
+#include <spdlog/spdlog.h>
+
+namespace http = boost::beast::http;
+
+AsyncRestClient::AsyncRestClient(boost::asio::io_context& io_context, boost::asio::ssl::context& ssl_context,
+                                 const std::string& host, const std::string& port, size_t connections)
+    : _io_context(io_context), _shared(std::make_shared<Shared>(ssl_context, host, port))
+{
+    for (size_t i = 0; i < std::max<size_t>(connections, 1); ++i)
+    {
+        _connections.push_back(std::make_shared<Connection>(_shared, _io_context));
+    }
+}
+
+AsyncRestClient::~AsyncRestClient()
+{
+    {
+        // Waits for handlers already running on io threads; none start afterwards.
+        std::unique_lock<std::shared_mutex> lock(_shared->lifetime);
+        _shared->closed = true;
+    }
+
+    for (auto& connection : _connections)
+    {
+        connection->close();
+    }
+}
+
+void AsyncRestClient::request(const std::string& target, std::string body, Handler handler)
+{
+    size_t index = _nextConnection.fetch_add(1, std::memory_order_relaxed) % _connections.size();
+    Metrics::setGauge(Gauge::AsyncRequestsInFlight, _shared->in_flight.fetch_add(1, std::memory_order_relaxed) + 1);
+    Metrics::setGauge(Gauge::RestQueueDepth, _shared->queued.fetch_add(1, std::memory_order_relaxed) + 1);
+    _connections[index]->enqueue({target, std::move(body), std::move(handler)});
+}
+
+void AsyncRestClient::setAccessToken(const std::string& token)
+{
+    std::lock_guard<std::mutex> lock(_shared->token_mutex);
+    _shared->access_token = token;
+}
+
+std::string AsyncRestClient::Shared::accessToken() const
+{
+    std::lock_guard<std::mutex> lock(token_mutex);
+    return access_token;
+}
+
+AsyncRestClient::Connection::Connection(std::shared_ptr<Shared> shared, boost::asio::io_context& io_context)
+    : _shared(std::move(shared)), _strand(boost::asio::make_strand(io_context)), _resolver(_strand)
+{
+}
+
+void AsyncRestClient::Connection::enqueue(PendingRequest request)
+{
+    boost::asio::post(_strand, [self = shared_from_this(), request = std::move(request)]() mutable {
+        self->_queue.push_back(std::move(request));
+
+        auto lock = self->lockOwner();
+        if (lock.owns_lock() && !self->_busy)
+        {
+            self->next();
+        }
+    });
+}
+
+void AsyncRestClient::Connection::close()
+{
+    boost::asio::post(_strand, [self = shared_from_this()]() {
+        self->lockOwner();
+    });
+}
+
+std::shared_lock<std::shared_mutex> AsyncRestClient::Connection::lockOwner()
+{
+    std::shared_lock<std::shared_mutex> lock(_shared->lifetime);
+    if (_shared->closed)
+    {
+        lock.unlock();
+        abandon();
+    }
+    return lock;
+}
+
+void AsyncRestClient::Connection::abandon()
+{
+    for (const PendingRequest& pending : _queue)
+    {
+        Metrics::setGauge(Gauge::AsyncRequestsInFlight, _shared->in_flight.fetch_sub(1, std::memory_order_relaxed) - 1);
+        if (!pending.sent)
+        {
+            Metrics::setGauge(Gauge::RestQueueDepth, _shared->queued.fetch_sub(1, std::memory_order_relaxed) - 1);
+        }
+    }
+
+    // The handlers may reference the destroyed owner, so they are released uncalled.
+    _queue.clear();
+    _busy = false;
+    _connected = false;
+    _resolver.cancel();
+
+    if (_stream)
+    {
+        boost::system::error_code ec;
+        boost::beast::get_lowest_layer(*_stream).socket().close(ec);
+    }
+}
+
+void AsyncRestClient::Connection::next()
+{
+    if (_queue.empty())
+    {
+        _busy = false;
+        return;
+    }
+
+    _busy = true;
+
+    if (_connected)
+    {
+        send();
+    }
+    else
+    {
+        connect();
+    }
+}
+
+void AsyncRestClient::Connection::connect()
+{
+    _stream = std::make_unique<boost::beast::ssl_stream<boost::beast::tcp_stream>>(_strand, _shared->ssl_context);
+    _buffer.clear();
+
+    if (!SSL_set_tlsext_host_name(_stream->native_handle(), _shared->host.c_str()))
+    {
+        complete(boost::system::error_code(static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()));
+        return;
+    }
+
+    if (_shared->session_cache)
+    {
+        _shared->session_cache->resume(_stream->native_handle());
+    }
+
+    _resolver.async_resolve(_shared->host, _shared->port,
+        [self = shared_from_this()](boost::system::error_code ec, boost::asio::ip::tcp::resolver::results_type results) {
+            auto lock = self->lockOwner();
+            if (!lock.owns_lock())
+            {
+                return;
+            }
+
+            if (ec)
+            {
+                self->complete(ec);
+                return;
+            }
+
+            auto& tcp = boost::beast::get_lowest_layer(*self->_stream);
+            tcp.expires_after(std::chrono::seconds(30));
+            tcp.async_connect(results, [self](boost::system::error_code ec, const boost::asio::ip::tcp::endpoint&) {
+                auto lock = self->lockOwner();
+                if (!lock.owns_lock())
+                {
+                    return;
+                }
+
+                if (ec)
+                {
+                    self->complete(ec);
+                    return;
+                }
+
+                boost::beast::get_lowest_layer(*self->_stream).socket().set_option(boost::asio::ip::tcp::no_delay(true), ec);
+                self->_stream->async_handshake(boost::asio::ssl::stream_base::client, [self](boost::system::error_code ec) {
+                    auto lock = self->lockOwner();
+                    if (!lock.owns_lock())
+                    {
+                        return;
+                    }
+
+                    if (ec)
+                    {
+                        self->complete(ec);
+                        return;
+                    }
+
+                    if (SSL_session_reused(self->_stream->native_handle()))
+                    {
+                        Metrics::increment(Counter::TlsSessionsResumed);
+                    }
+
+                    self->_connected = true;
+                    self->_requestsOnConnection = 0;
+                    self->send();
+                });
+            });
+        });
+}
+
+void AsyncRestClient::Connection::send()
+{
+    PendingRequest& pending = _queue.front();
+    if (!pending.sent)
+    {
+        pending.sent = true;
+        Metrics::setGauge(Gauge::RestQueueDepth, _shared->queued.fetch_sub(1, std::memory_order_relaxed) - 1);
+    }
+    ++_requestsOnConnection;
+
+    _request = {};
+    _request.method(http::verb::post);
+    _request.target(pending.target);
+    _request.version(11);
+    _request.set(http::field::host, _shared->host);
+    _request.set(http::field::content_type, "application/json");
+    _request.keep_alive(true);
+
+    std::string token = _shared->accessToken();
+    if (!token.empty())
+    {
+        _request.set(http::field::authorization, "Bearer " + token);
+    }
+
+    _request.body() = std::move(pending.body);
+    _request.prepare_payload();
+    _response = {};
+    _sentAt = std::chrono::steady_clock::now();
+
+    boost::beast::get_lowest_layer(*_stream).expires_after(std::chrono::seconds(30));
+    http::async_write(*_stream, _request, [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+        auto lock = self->lockOwner();
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+
+        if (ec)
+        {
+            if (!self->resendOnStale(ec))
+            {
+                self->complete(ec);
+            }
+            return;
+        }
+
+        http::async_read(*self->_stream, self->_buffer, self->_response, [self](boost::system::error_code ec, std::size_t bytes) {
+            auto lock = self->lockOwner();
+            if (!lock.owns_lock())
+            {
+                return;
+            }
+
+            if (ec && bytes == 0 && self->resendOnStale(ec))
+            {
+                return;
+            }
+
+            self->complete(ec);
+        });
+    });
+}
+
+bool AsyncRestClient::Connection::resendOnStale(boost::system::error_code ec)
+{
+    PendingRequest& pending = _queue.front();
+
+    // Only a connection that already served a request can have been closed
+    // by the server while idle; a fresh one failing is a real error.
+    if (pending.resent || _requestsOnConnection <= 1)
+    {
+        return false;
+    }
+
+    spdlog::warn("Keep-alive connection to {} went stale ({}). Reconnecting to resend {}.", _shared->host, ec.message(), pending.target);
+    Metrics::increment(Counter::Reconnects);
+
+    pending.resent = true;
+    pending.body = std::move(_request.body());
+    _connected = false;
+    connect();
+    return true;
+}
+
+void AsyncRestClient::Connection::complete(boost::system::error_code ec)
+{
+    PendingRequest pending = std::move(_queue.front());
+    _queue.pop_front();
+    Metrics::setGauge(Gauge::AsyncRequestsInFlight, _shared->in_flight.fetch_sub(1, std::memory_order_relaxed) - 1);
+    if (!pending.sent)
+    {
+        Metrics::setGauge(Gauge::RestQueueDepth, _shared->queued.fetch_sub(1, std::memory_order_relaxed) - 1);
+    }
+
+    nlohmann::json response;
+    if (!ec)
+    {
+        Metrics::increment(Counter::RestRequests);
+        Metrics::observe(Histogram::RestLatency, std::chrono::steady_clock::now() - _sentAt);
+
+        try
+        {
+            response = nlohmann::json::parse(_response.body());
+        }
+        catch (const nlohmann::json::exception& ex)
+        {
+            spdlog::error("JSON parsing error: {}", ex.what());
+            ec = boost::system::errc::make_error_code(boost::system::errc::bad_message);
+        }
+
+        if (!_response.keep_alive())
+        {
+            _connected = false;
+        }
+    }
+    else
+    {
+        spdlog::error("Async request error on {}: {}", pending.target, ec.message());
+        _connected = false;
+    }
+
+    if (ec)
+    {
+        Metrics::increment(Counter::RestErrors);
+    }
+
+    if (pending.handler)
+    {
+        pending.handler(ec, std::move(response));
+    }
+
+    next();
+}
@@ -0,0 +1,251 @@
+#include "BookAnalytics.hpp"
+#include "Metrics.hpp"
+#include <spdlog/spdlog.h>
+
+namespace
+{
+    template <size_t N>
+    struct LevelWeights {
+        alignas(32) double values[N] = {};
+
+        constexpr LevelWeights()
+        {
+            for (size_t i = 0; i < BookAnalytics::depth; ++i)
+            {
+                values[i] = 1.0 / static_cast<double>(i + 1);
+            }
+        }
+    };
+
+    double ratio(double a, double b)
+    {
+        double total = a + b;
+        return total > 0.0 ? (a - b) / total : 0.0;
+    }
+}
+
+BookAnalytics::BookAnalytics()
+    : _slots(new Slot[max_instruments])
+{
+}
+
+int BookAnalytics::registerInstrument(const std::string& instrument_name)
+{
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+
+    auto it = _instrumentIndex.find(instrument_name);
+    if (it != _instrumentIndex.end())
+    {
+        return static_cast<int>(it->second);
+    }
+
+    size_t index = _instrumentCount.load(std::memory_order_relaxed);
+    if (index >= max_instruments)
+    {
+        spdlog::warn("Book analytics is full ({} instruments). {} will not be analysed.", max_instruments, instrument_name);
+        return -1;
+    }
+
+    _slots[index].instrument_name = instrument_name;
+    _instrumentIndex.emplace(instrument_name, index);
+    _instrumentCount.store(index + 1, std::memory_order_release);
+    return static_cast<int>(index);
+}
+
+int BookAnalytics::findInstrument(const std::string& instrument_name)
+{
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+
+    auto it = _instrumentIndex.find(instrument_name);
+    return it == _instrumentIndex.end() ? -1 : static_cast<int>(it->second);
+}
+
+template <typename Levels>
+void BookAnalytics::refill(Side& side, const Levels& levels)
+{
+    size_t count = 0;
+    for (auto it = levels.begin(); it != levels.end() && count < depth; ++it, ++count)
+    {
+        side.prices[count] = it->first;
+        side.amounts[count] = it->second;
+    }
+
+    for (size_t i = count; i < padded_depth; ++i)
+    {
+        side.prices[i] = 0.0;
+        side.amounts[i] = 0.0;
+    }
+
+    side.count = count;
+    side.in_place_updates = 0;
+    recompute(side);
+}
+
+template <typename Levels>
+void BookAnalytics::applySide(Side& side, const std::vector<BookLevelChange>& changes, const Levels& levels, bool bids)
+{
+    if (changes.empty())
+    {
+        return;
+    }
+
+    if (!applyChanges(side, changes, bids) || ++side.in_place_updates >= resum_interval)
+    {
+        refill(side, levels);
+        Metrics::increment(Counter::AnalyticsRecomputes);
+    }
+}
+
+void BookAnalytics::recompute(Side& side)
+{
+    static constexpr LevelWeights<padded_depth> weights;
+
+    // Same four-lane shape as the trade tape kernels: independent accumulators,
+    // zero-padded arrays, no tail loop, so the compiler emits packed adds and multiplies.
+    double d[4] = {0.0, 0.0, 0.0, 0.0};
+    double p[4] = {0.0, 0.0, 0.0, 0.0};
+
+    for (size_t i = 0; i < padded_depth; i += 4)
+    {
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            double amount = side.amounts[i + lane];
+            d[lane] += amount;
+            p[lane] += amount * weights.values[i + lane];
+        }
+    }
+
+    side.size = (d[0] + d[1]) + (d[2] + d[3]);
+    side.pressure = (p[0] + p[1]) + (p[2] + p[3]);
+}
+
+bool BookAnalytics::applyChanges(Side& side, const std::vector<BookLevelChange>& changes, bool bids)
+{
+    static constexpr LevelWeights<padded_depth> weights;
+
+    for (const BookLevelChange& change : changes)
+    {
+        size_t level = 0;
+        while (level < side.count && side.prices[level] != change.price)
+        {
+            ++level;
+        }
+
+        if (level < side.count)
+        {
+            if (change.action == BookLevelChange::Action::Delete || change.amount <= 0.0)
+            {
+                return false;
+            }
+
+            double delta = change.amount - side.amounts[level];
+            side.amounts[level] = change.amount;
+            side.size += delta;
+            side.pressure += delta * weights.values[level];
+            continue;
+        }
+
+        if (change.action == BookLevelChange::Action::Delete)
+        {
+            continue;
+        }
+
+        bool inside = side.count < depth
+                   || (bids ? change.price > side.prices[side.count - 1] : change.price < side.prices[side.count - 1]);
+        if (inside)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BookAnalytics::apply(size_t instrument_index, const BookUpdate& update, const OrderBook& book)
+{
+    if (instrument_index >= _instrumentCount.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    Slot& slot = _slots[instrument_index];
+
+    if (update.is_snapshot)
+    {
+        rebuild(instrument_index, book);
+        return;
+    }
+
+    applySide(slot.bids, update.bids, book.bids(), true);
+    applySide(slot.asks, update.asks, book.asks(), false);
+
+    publish(slot, book);
+}
+
+void BookAnalytics::rebuild(size_t instrument_index, const OrderBook& book)
+{
+    if (instrument_index >= _instrumentCount.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    Slot& slot = _slots[instrument_index];
+    refill(slot.bids, book.bids());
+    refill(slot.asks, book.asks());
+    Metrics::increment(Counter::AnalyticsRecomputes, 2);
+    publish(slot, book);
+}
+
+void BookAnalytics::publish(Slot& slot, const OrderBook& book)
+{
+    const Side& bids = slot.bids;
+    const Side& asks = slot.asks;
+
+    BookMetrics metrics;
+    metrics.timestamp = book.timestamp();
+    metrics.change_id = book.changeId();
+    metrics.updates = ++slot.updates;
+
+    if (bids.count > 0)
+    {
+        metrics.best_bid = bids.prices[0];
+        metrics.best_bid_amount = bids.amounts[0];
+    }
+
+    if (asks.count > 0)
+    {
+        metrics.best_ask = asks.prices[0];
+        metrics.best_ask_amount = asks.amounts[0];
+    }
+
+    if (bids.count > 0 && asks.count > 0)
+    {
+        metrics.spread = metrics.best_ask - metrics.best_bid;
+        metrics.mid = 0.5 * (metrics.best_bid + metrics.best_ask);
+
+        double size = metrics.best_bid_amount + metrics.best_ask_amount;
+        metrics.microprice = size > 0.0
+            ? (metrics.best_bid * metrics.best_ask_amount + metrics.best_ask * metrics.best_bid_amount) / size
+            : metrics.mid;
+    }
+
+    metrics.bid_depth = bids.size;
+    metrics.ask_depth = asks.size;
+    metrics.depth_imbalance = ratio(bids.size, asks.size);
+    metrics.bid_pressure = bids.pressure;
+    metrics.ask_pressure = asks.pressure;
+    metrics.book_pressure = ratio(bids.pressure, asks.pressure);
+
+    slot.metrics.store(metrics);
+}
+
+bool BookAnalytics::snapshot(size_t instrument_index, BookMetrics& out) const
+{
+    if (instrument_index >= _instrumentCount.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    _slots[instrument_index].metrics.load(out);
+    return true;
+}
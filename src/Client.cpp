@@ -1,4 +1,6 @@
 #include "Client.hpp"
+#include "Metrics.hpp"
+#include "MarketDataParser.hpp"
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/asio/connect.hpp>
@@ -9,6 +11,10 @@
 #include <boost/beast/websocket/teardown.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 
 namespace boost 
 {
@@ -31,7 +37,14 @@ namespace boost
 using json = nlohmann::json;
 
 Client::Client(const std::string& host, const std::string& port, const std::string& clientId, const std::string& secreatKey)
-    : _wsConnected(false), _io_context_ws(), _ssl_context_ws(boost::asio::ssl::context::tlsv12_client), _ws(_io_context_ws, _ssl_context_ws), _ssl_context(boost::asio::ssl::context::tlsv13_client), _host(host), _port(port), _clientId(clientId), _secreatKey(secreatKey)
+    : _wsConnected(false), _io_context_ws(), _ssl_context_ws(boost::asio::ssl::context::tlsv12_client), _ws(_io_context_ws, _ssl_context_ws), _ssl_context(boost::asio::ssl::context::tlsv13_client), _host(host), _port(port), _clientId(clientId), _secreatKey(secreatKey),
+      _amendments(
+        [this](const std::string& order_id, double amount, double price, OrderAmendmentQueue::Completion completion) {
+            startModifyOrder(order_id, amount, price, std::move(completion));
+        },
+        [this](const std::string& order_id, OrderAmendmentQueue::Completion completion) {
+            startCancelOrder(order_id, std::move(completion));
+        })
 {
     _ssl_context_ws.set_default_verify_paths();
     _ssl_context_ws.set_verify_mode(boost::asio::ssl::verify_peer);
@@ -45,18 +58,61 @@ Client::Client(const std::string& host, const std::string& port, const std::stri
     ssl_stream = std::make_shared<boost::asio::ssl::stream<boost::asio::ip::tcp::socket>>(_io_context, _ssl_context);
 }
 
-void Client::connect() 
+void Client::resolve()
 {
     try 
     {
         boost::asio::ip::tcp::resolver resolver(_io_context);
-        auto endpoints = resolver.resolve(_host, _port);
-        boost::asio::connect(ssl_stream->lowest_layer(), endpoints);
+        auto results = resolver.resolve(_host, _port);
+
+        std::lock_guard<std::mutex> lock(_endpointMutex);
+        _endpoints = std::move(results);
+        spdlog::info("Resolved {} to {} endpoint(s)", _host, _endpoints.size());
+    } 
+    catch (const boost::system::system_error& ex) 
+    {
+        spdlog::error("Resolve error: {}", ex.what());
+        throw;
+    }
+}
+
+boost::asio::ip::tcp::resolver::results_type Client::endpoints()
+{
+    {
+        std::lock_guard<std::mutex> lock(_endpointMutex);
+        if (!_endpoints.empty())
+        {
+            return _endpoints;
+        }
+    }
+
+    resolve();
+
+    std::lock_guard<std::mutex> lock(_endpointMutex);
+    return _endpoints;
+}
+
+void Client::connect() 
+{
+    std::lock_guard<std::mutex> lock(_restMutex);
+
+    try 
+    {
+        if (_restConnected)
+        {
+            // Reconnect: an SSL stream cannot be handshaken again once used.
+            boost::system::error_code ec;
+            ssl_stream->lowest_layer().close(ec);
+            ssl_stream = std::make_shared<boost::asio::ssl::stream<boost::asio::ip::tcp::socket>>(_io_context, _ssl_context);
+            _restConnected = false;
+        }
+
+        boost::asio::connect(ssl_stream->lowest_layer(), endpoints());
         ssl_stream->handshake(boost::asio::ssl::stream_base::client);
         boost::asio::ip::tcp::no_delay option(true);
         ssl_stream->lowest_layer().set_option(option);
         spdlog::info("Connected to {}:{}", _host, _port);
-        startPing();
+        _restConnected = true;
     } 
     catch (const boost::system::system_error& ex) 
     {
@@ -67,8 +123,15 @@ void Client::connect()
 
 Client::~Client()
 {
+    // Drop the async client first: its in-flight handlers capture this and
+    // reference members (such as _amendments) declared after it.
+    _asyncRest.reset();
+
     try 
     {
+        // Stop the ping thread before closing: a failed ping reconnects and replaces ssl_stream.
+        stopPing();
+
         if (ssl_stream) 
         {
             ssl_stream->lowest_layer().close();
@@ -85,7 +148,6 @@ Client::~Client()
             }
         }
 
-        stopPing();
         spdlog::info("Client resources cleaned up.");
     } 
     catch (const std::exception& ex) 
@@ -122,18 +184,26 @@ void Client::pingServer()
         if (!response.is_null()) 
         {
             std::cin.clear();
+            return;
         } 
-        else 
-        {
-            spdlog::warn("Ping failed. Reconnecting...");
-            connect();
-        }
+
+        spdlog::warn("Ping failed. Reconnecting...");
     } 
     catch (const std::exception& ex) 
     {
         spdlog::error("Ping error: {}", ex.what());
+    }
+
+    Metrics::increment(Counter::Reconnects);
+
+    try
+    {
         connect();
     }
+    catch (const std::exception&)
+    {
+        // Already logged by connect(); the next ping tries again.
+    }
 }
 
 void Client::logLatency(const std::chrono::duration<double>& duration) 
@@ -156,6 +226,11 @@ void Client::logLatency(const std::chrono::duration<double>& duration)
 
 void Client::startPing() 
 {
+    if (ping_thread.joinable())
+    {
+        return;
+    }
+
     is_running = true;
     ping_timer = std::make_unique<boost::asio::steady_timer>(_io_context);
 
@@ -199,106 +274,156 @@ void Client::stopPing()
 
 std::string Client::getAccessToken()
 {
+    std::lock_guard<std::mutex> lock(_tokenMutex);
     return _accessToken;
 }
 
 void Client::setAccessToken(std::string &token)
 {
-    _accessToken = token;
+    {
+        std::lock_guard<std::mutex> lock(_tokenMutex);
+        _accessToken = token;
+    }
+
+    if (_asyncRest)
+    {
+        _asyncRest->setAccessToken(token);
+    }
 }
 
-json Client::sendRequest(const std::string& endpoint, const std::string& method, const json& payload) 
+const std::string& Client::sendRaw(const std::string& endpoint, const std::string& method, std::string_view payload)
 {
+    // Per-thread buffers keep their capacity between requests, so the steady
+    // state builds requests and reads responses without touching the heap.
+    thread_local std::string request_buffer;
+    thread_local std::string response_buffer;
+    thread_local std::string response_body;
+
+    response_body.clear();
+
     try 
     {
         auto start = std::chrono::high_resolution_clock::now();
-        std::string serialized_payload = payload.dump();
 
-        std::ostringstream request_stream;
-        request_stream << method << " " << endpoint << " HTTP/1.1\r\n"
-                    << "Host: " << _host << "\r\n";
+        request_buffer.clear();
+        request_buffer.append(method).append(" ").append(endpoint).append(" HTTP/1.1\r\n")
+                      .append("Host: ").append(_host).append("\r\n");
 
-        if (!_accessToken.empty()) 
         {
-            request_stream << "Authorization: Bearer " << _accessToken << "\r\n";
+            std::lock_guard<std::mutex> lock(_tokenMutex);
+            if (!_accessToken.empty()) 
+            {
+                request_buffer.append("Authorization: Bearer ").append(_accessToken).append("\r\n");
+            }
         }
 
-        request_stream << "Content-Type: application/json\r\n"
-                    << "Content-Length: " << serialized_payload.size() << "\r\n"
-                    << "Connection: keep-alive\r\n\r\n"
-                    << serialized_payload;
+        char content_length_value[24];
+        int content_length_size = std::snprintf(content_length_value, sizeof(content_length_value), "%zu", payload.size());
 
-        boost::asio::write(*ssl_stream, boost::asio::buffer(request_stream.str()));
-        boost::asio::streambuf response_buffer;
-        std::size_t max_buffer_size = 1024;
-        response_buffer.prepare(max_buffer_size);
+        request_buffer.append("Content-Type: application/json\r\n")
+                      .append("Content-Length: ").append(content_length_value, static_cast<size_t>(content_length_size)).append("\r\n")
+                      .append("Connection: keep-alive\r\n\r\n")
+                      .append(payload);
 
-        std::size_t bytes_read = boost::asio::read(*ssl_stream, response_buffer, boost::asio::transfer_at_least(1));
-        response_buffer.commit(bytes_read);
+        std::lock_guard<std::mutex> lock(_restMutex);
 
-        if (response_buffer.size() > max_buffer_size) 
-        {
-            throw std::runtime_error("Buffer overflow: Maximum size exceeded");
-        }
-    
-        std::istream response_stream(&response_buffer);
+        boost::asio::write(*ssl_stream, boost::asio::buffer(request_buffer));
 
-        std::string header;
+        response_buffer.clear();
+        std::size_t header_size = boost::asio::read_until(*ssl_stream, boost::asio::dynamic_buffer(response_buffer), "\r\n\r\n");
+
+        std::string_view headers(response_buffer.data(), header_size);
         size_t content_length = 0;
-        while (std::getline(response_stream, header) && header != "\r") 
+        size_t field = headers.find("\r\nContent-Length:");
+        if (field != std::string_view::npos) 
         {
-            if (header.find("Content-Length:") == 0) 
-            {
-                content_length = std::stoul(header.substr(16));
-            }
+            content_length = std::strtoul(headers.data() + field + 17, nullptr, 10);
         }
 
-        std::string response_body;
-        response_body.reserve(content_length);
+        response_body.assign(response_buffer, header_size, std::string::npos);
 
-        if (response_buffer.size() > 0) 
+        if (response_body.size() < content_length) 
         {
-            response_body.append(boost::asio::buffer_cast<const char*>(response_buffer.data()),
-                response_buffer.size()
-            );
-            response_buffer.consume(response_buffer.size());
+            size_t received = response_body.size();
+            response_body.resize(content_length);
+            boost::asio::read(*ssl_stream, boost::asio::buffer(&response_body[received], content_length - received));
         }
 
-        while (response_body.size() < content_length) 
-        {
-            std::vector<char> temp_buffer(8192);
-            size_t bytes_read = boost::asio::read(
-                *ssl_stream,
-                boost::asio::buffer(temp_buffer),
-                boost::asio::transfer_at_least(1)
-            );
-            response_body.append(temp_buffer.data(), bytes_read);
-        }
+        auto end = std::chrono::high_resolution_clock::now();
+        Metrics::increment(Counter::RestRequests);
+        Metrics::observe(Histogram::RestLatency, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
 
-        if (serialized_payload.find("public/test") == std::string::npos) 
+        if (payload.find("public/test") == std::string_view::npos) 
         {
-            auto end = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> duration = end - start;
             logLatency(duration);
         }
+    } 
+    catch (const std::exception& ex)
+    {
+        spdlog::error("Request error: {}", ex.what());
+        Metrics::increment(Counter::RestErrors);
+        response_body.clear();
+    }
 
-        return json::parse(response_body);
+    return response_body;
+}
+
+json Client::sendRequest(const std::string& endpoint, const std::string& method, const json& payload) 
+{
+    const std::string& body = sendRaw(endpoint, method, payload.dump());
+    if (body.empty())
+    {
+        return json();
+    }
+
+    try 
+    {
+        return json::parse(body);
     } 
     catch (const json::exception& ex)
     {
         spdlog::error("JSON parsing error: {}", ex.what());
-    } 
-    catch (const std::exception& ex)
-    {
-        spdlog::error("Request error: {}", ex.what());
+        Metrics::increment(Counter::RestErrors);
     }
 
     return json();
 }
 
+const std::string& Client::sendOrderRequest(const std::string& endpoint, const std::string& payload)
+{
+    if (_paperExchange)
+    {
+        thread_local std::string paper_body;
+        paper_body = _paperExchange->handleRequest(json::parse(payload)).dump();
+        return paper_body;
+    }
+
+    return sendRaw(endpoint, "POST", payload);
+}
+
+void Client::enablePaperTrading(std::shared_ptr<PaperExchange> exchange)
+{
+    _paperExchange = std::move(exchange);
+    spdlog::info("Paper trading {}: orders are matched locally and never sent to {}.", _paperExchange ? "enabled" : "disabled", _host);
+}
+
+void Client::recordMarketData(const std::string& path)
+{
+    _recording.open(path, std::ios::app);
+    if (!_recording)
+    {
+        spdlog::error("Unable to open market data recording file: {}", path);
+        return;
+    }
+
+    spdlog::info("Recording market data to {}", path);
+}
+
 void Client::placeOrder(const std::string& instrument_name, double amount, double price, const std::string& order_type)
 {
-    json params = {
+    ArenaScope scope;
+    ArenaJson params = {
         {"instrument_name", instrument_name},
         {"amount", amount},
         {"type", order_type}
@@ -309,36 +434,107 @@ void Client::placeOrder(const std::string& instrument_name, double amount, doubl
         params["price"] = price;
     }
 
-    json payloadPlaceOrder = getCachedPayload("/api/v2/private/buy", "private/buy", params);
+    Payload payloadPlaceOrder = cachedRequest("/api/v2/private/buy", "private/buy", params.dump());
 
     try
     {
-        json response = sendRequest("/api/v2/private/buy", "POST", payloadPlaceOrder);
+        ArenaJson response = parseArenaResponse(sendOrderRequest("/api/v2/private/buy", *payloadPlaceOrder));
 
         if (!response.is_null() && response.contains("error")) 
         {
             spdlog::error("Order placement failed: {}", response["error"].dump(4));
             throw std::runtime_error("Order placement error");
         }
-        storeOrder(response);
+
+        // Paper orders live in the PaperExchange; keep them out of the live history file.
+        if (!_paperExchange)
+        {
+            storeOrderFrom(response);
+        }
+        Metrics::increment(Counter::OrdersPlaced);
         spdlog::info("Order placed successfully: {}", response.dump(4));
     }
     catch (const std::exception& e)
     {
         spdlog::error("PlaceOrder Request error: {}", e.what());
+        Metrics::increment(Counter::OrderErrors);
+        throw;
+    }
+}
+
+void Client::loadInstruments(const std::string& currency)
+{
+    ArenaScope scope;
+    ArenaJson params = {
+        {"currency", currency},
+        {"expired", false}
+    };
+
+    Payload payload = cachedRequest("/api/v2/public/get_instruments", "public/get_instruments", params.dump());
+
+    try
+    {
+        ArenaJson response = parseArenaResponse(sendRaw("/api/v2/public/get_instruments", "POST", *payload));
+        if (response.is_null() || !response.contains("result"))
+        {
+            ArenaString body = response.dump();
+            throw std::runtime_error("Instrument metadata request failed: " + std::string(body.data(), body.size()));
+        }
+
+        std::lock_guard<std::mutex> lock(_instrumentInfoMutex);
+        for (const auto& instrument : response["result"])
+        {
+            const ArenaString& name = instrument["instrument_name"].get_ref<const ArenaString&>();
+
+            InstrumentInfo info;
+            const ArenaString& kind = instrument["kind"].get_ref<const ArenaString&>();
+            info.kind.assign(kind.data(), kind.size());
+            info.tick_size = instrument.value("tick_size", 0.0);
+            info.min_trade_amount = instrument.value("min_trade_amount", 0.0);
+            info.contract_size = instrument.value("contract_size", 0.0);
+
+            _instrumentInfo[std::string(name.data(), name.size())] = std::move(info);
+        }
+
+        spdlog::info("Loaded metadata for {} {} instruments", response["result"].size(), currency);
+    }
+    catch (const std::exception& e)
+    {
+        spdlog::error("Instrument metadata error: {}", e.what());
         throw;
     }
 }
 
+bool Client::instrumentInfo(const std::string& instrument_name, InstrumentInfo& out) const
+{
+    std::lock_guard<std::mutex> lock(_instrumentInfoMutex);
+    auto it = _instrumentInfo.find(instrument_name);
+    if (it == _instrumentInfo.end())
+    {
+        return false;
+    }
+
+    out = it->second;
+    return true;
+}
+
 void Client::storeOrder(const json& orderResponse)
+{
+    storeOrderFrom(orderResponse);
+}
+
+template <typename Json>
+void Client::storeOrderFrom(const Json& orderResponse)
 {
     try 
     {
-        const auto& order = orderResponse["result"]["order"];
-        std::string instrumentName = order["instrument_name"];
-        std::string orderId = order["order_id"];
+        const auto& order = orderResponse.at("result").at("order");
+        std::string instrumentName = order.at("instrument_name").template get<std::string>();
+        std::string orderId = order.at("order_id").template get<std::string>();
 
+        std::lock_guard<std::mutex> lock(_ordersMutex);
         openOrders.insert({instrumentName, orderId});
+        Metrics::setGauge(Gauge::OpenOrders, static_cast<int64_t>(openOrders.size()));
 
         std::ofstream outFile("order_history.json", std::ios::app);
         if (outFile) 
@@ -361,6 +557,7 @@ void Client::storeOrder(const json& orderResponse)
 
 void Client::loadOrderHistory()
 {
+    std::lock_guard<std::mutex> lock(_ordersMutex);
     std::ifstream inFile("order_history.json");
     if (!inFile) 
     {
@@ -376,6 +573,12 @@ void Client::loadOrderHistory()
             nlohmann::json orderData = nlohmann::json::parse(line);
             std::string instrumentName = orderData["instrument_name"];
             std::string orderId = orderData["order_id"];
+
+            // Simulated ids written by older builds are not live orders.
+            if (orderId.compare(0, 6, "paper-") == 0)
+            {
+                continue;
+            }
             openOrders.insert({instrumentName, orderId});
         } 
         catch (const std::exception& ex) 
@@ -384,11 +587,29 @@ void Client::loadOrderHistory()
         }
     }
 
+    Metrics::setGauge(Gauge::OpenOrders, static_cast<int64_t>(openOrders.size()));
+
     inFile.close();
 }
 
 void Client::listOpenOrders()
 {
+    if (_paperExchange)
+    {
+        json paperOrders = _paperExchange->openOrders();
+        if (paperOrders.empty())
+        {
+            spdlog::info("No open orders found.");
+        }
+
+        for (const auto& order : paperOrders)
+        {
+            std::cout << "Instrument: " << order["instrument_name"].get<std::string>() << ", Order ID: " << order["order_id"].get<std::string>() << " (paper)" << std::endl;
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_ordersMutex);
     if (openOrders.empty()) 
     {
         spdlog::info("No open orders found.");
@@ -404,71 +625,80 @@ void Client::listOpenOrders()
 
 void Client::cancelOrder(const std::string& order_id)
 {
-    json params = {
+    ArenaScope scope;
+    ArenaJson params = {
         {"order_id", order_id}
     };
 
-    json cancelOrderPayload = getCachedPayload("/api/v2/private/cancel", "private/cancel", params);
+    Payload cancelOrderPayload = cachedRequest("/api/v2/private/cancel", "private/cancel", params.dump());
 
     try
     {
-        json response = sendRequest("/api/v2/private/cancel", "POST", cancelOrderPayload);
+        ArenaJson response = parseArenaResponse(sendOrderRequest("/api/v2/private/cancel", *cancelOrderPayload));
         if (response.contains("result")) 
         {
             spdlog::info("Order Cancled Successfully...");
+            Metrics::increment(Counter::OrdersCancelled);
         } 
         else 
         {
             spdlog::warn("Something weird happens : {}", response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
         }
     }
     catch(const std::exception& e)
     {
         spdlog::error("Order Cancel Request error: {}", e.what());
+        Metrics::increment(Counter::OrderErrors);
         throw;
     }
 }
 
 void Client::modifyOrder(const std::string& order_id, double amount, double price)
 {
-    json params = {
+    ArenaScope scope;
+    ArenaJson params = {
         {"order_id", order_id},
         {"amount", amount},
         {"price", price}
     };
 
-    json orderModifyPayload = getCachedPayload("/api/v2/private/edit", "private/edit", params);
+    Payload orderModifyPayload = cachedRequest("/api/v2/private/edit", "private/edit", params.dump());
 
     try
     {
-        json response = sendRequest("/api/v2/private/edit", "POST", orderModifyPayload);
+        ArenaJson response = parseArenaResponse(sendOrderRequest("/api/v2/private/edit", *orderModifyPayload));
         if (response.contains("result")) 
         {
             spdlog::info("Order modified Successfully...");
+            Metrics::increment(Counter::OrdersModified);
         } 
         else 
         {
             spdlog::warn("Something weird happens : {}", response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
         }
     }
     catch(const std::exception& e)
     {
         spdlog::error("Order modify Request error: {}", e.what());
+        Metrics::increment(Counter::OrderErrors);
     }
 }
 
 void Client::getOrderBook(const std::string& instrument_name)
 {
-    json params = {
+    ArenaScope scope;
+    ArenaJson params = {
         {"instrument_name", instrument_name},
         {"depth", 5}
     };
 
-    json orderModifyPayload = getCachedPayload("/api/v2/private/get_open_orders", "private/get_open_orders", params);
+    Payload orderBookPayload = cachedRequest("/api/v2/public/get_order_book", "public/get_order_book", params.dump());
 
     try
     {
-        json response = sendRequest("/api/v2/private/get_open_orders", "POST", orderModifyPayload);
+        ArenaJson response = parseArenaResponse(sendRaw("/api/v2/public/get_order_book", "POST", *orderBookPayload));
         if (response.contains("result")) 
         {
             spdlog::info("Order Book : {}", response.dump(4));
@@ -486,14 +716,15 @@ void Client::getOrderBook(const std::string& instrument_name)
 
 void Client::viewCurrentPositions()
 {
-    json params = {
+    ArenaScope scope;
+    ArenaJson params = {
     };
 
-    json payload = getCachedPayload("/api/v2/private/get_positions", "private/get_positions", params);
+    Payload payload = cachedRequest("/api/v2/private/get_positions", "private/get_positions", params.dump());
 
     try
     {
-        json response = sendRequest("/api/v2/private/get_positions", "POST", payload);
+        ArenaJson response = parseArenaResponse(sendRaw("/api/v2/private/get_positions", "POST", *payload));
 
         if (response.contains("result")) 
         {
@@ -510,6 +741,176 @@ void Client::viewCurrentPositions()
     }
 }
 
+void Client::attachAsync(boost::asio::io_context& io_context, size_t connections)
+{
+    _asyncRest = std::make_unique<AsyncRestClient>(io_context, _ssl_context, _host, _port, connections);
+    _asyncRest->setAccessToken(getAccessToken());
+}
+
+void Client::attachRuntime(SharedRuntime& runtime, size_t connections)
+{
+    _asyncRest = std::make_unique<AsyncRestClient>(runtime.context(), runtime.sslContext(), _host, _port, connections);
+    _asyncRest->setSessionCache(&runtime.sessionCache());
+    _asyncRest->setAccessToken(getAccessToken());
+}
+
+void Client::startRequest(const std::string& endpoint, std::string payload, AsyncRestClient::Handler handler)
+{
+    if (!_asyncRest)
+    {
+        spdlog::error("Asynchronous request to {} without an attached io_context.", endpoint);
+        handler(boost::asio::error::not_connected, json());
+        return;
+    }
+
+    _asyncRest->request(endpoint, std::move(payload), std::move(handler));
+}
+
+void Client::queueModifyOrder(const std::string& order_id, double amount, double price)
+{
+    _amendments.amend(order_id, amount, price);
+}
+
+void Client::queueCancelOrder(const std::string& order_id)
+{
+    _amendments.cancel(order_id);
+}
+
+OrderAmendmentQueue& Client::amendments()
+{
+    return _amendments;
+}
+
+void Client::startOrderRequest(const std::string& endpoint, const Payload& payload, AsyncRestClient::Handler handler)
+{
+    if (_paperExchange)
+    {
+        handler(boost::system::error_code(), _paperExchange->handleRequest(json::parse(*payload)));
+        return;
+    }
+
+    startRequest(endpoint, *payload, std::move(handler));
+}
+
+void Client::startPlaceOrder(const std::string& instrument_name, double amount, double price, const std::string& order_type, AsyncRestClient::Handler handler)
+{
+    Payload payloadPlaceOrder;
+    {
+        ArenaScope scope;
+        ArenaJson params = {
+            {"instrument_name", instrument_name},
+            {"amount", amount},
+            {"type", order_type}
+        };
+
+        if (order_type != "market") 
+        {
+            params["price"] = price;
+        }
+
+        payloadPlaceOrder = cachedRequest("/api/v2/private/buy", "private/buy", params.dump());
+    }
+
+    startOrderRequest("/api/v2/private/buy", payloadPlaceOrder, [this, handler = std::move(handler)](boost::system::error_code ec, json response) {
+        if (!ec && response.contains("result"))
+        {
+            if (!_paperExchange)
+            {
+                storeOrder(response);
+            }
+            Metrics::increment(Counter::OrdersPlaced);
+            spdlog::info("Order placed successfully: {}", response.dump(4));
+        }
+        else
+        {
+            spdlog::error("Order placement failed: {}", ec ? ec.message() : response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
+        }
+
+        handler(ec, std::move(response));
+    });
+}
+
+void Client::startCancelOrder(const std::string& order_id, AsyncRestClient::Handler handler)
+{
+    Payload cancelOrderPayload;
+    {
+        ArenaScope scope;
+        ArenaJson params = {
+            {"order_id", order_id}
+        };
+
+        cancelOrderPayload = cachedRequest("/api/v2/private/cancel", "private/cancel", params.dump());
+    }
+
+    startOrderRequest("/api/v2/private/cancel", cancelOrderPayload, [handler = std::move(handler)](boost::system::error_code ec, json response) {
+        if (!ec && response.contains("result"))
+        {
+            spdlog::info("Order Cancled Successfully...");
+            Metrics::increment(Counter::OrdersCancelled);
+        }
+        else
+        {
+            spdlog::warn("Order cancel failed : {}", ec ? ec.message() : response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
+        }
+
+        handler(ec, std::move(response));
+    });
+}
+
+void Client::startModifyOrder(const std::string& order_id, double amount, double price, AsyncRestClient::Handler handler)
+{
+    Payload orderModifyPayload;
+    {
+        ArenaScope scope;
+        ArenaJson params = {
+            {"order_id", order_id},
+            {"amount", amount},
+            {"price", price}
+        };
+
+        orderModifyPayload = cachedRequest("/api/v2/private/edit", "private/edit", params.dump());
+    }
+
+    startOrderRequest("/api/v2/private/edit", orderModifyPayload, [handler = std::move(handler)](boost::system::error_code ec, json response) {
+        if (!ec && response.contains("result"))
+        {
+            spdlog::info("Order modified Successfully...");
+            Metrics::increment(Counter::OrdersModified);
+        }
+        else
+        {
+            spdlog::warn("Order modify failed : {}", ec ? ec.message() : response.dump(4));
+            Metrics::increment(Counter::OrderErrors);
+        }
+
+        handler(ec, std::move(response));
+    });
+}
+
+void Client::startGetOrderBook(const std::string& instrument_name, AsyncRestClient::Handler handler)
+{
+    Payload orderBookPayload;
+    {
+        ArenaScope scope;
+        ArenaJson params = {
+            {"instrument_name", instrument_name},
+            {"depth", 5}
+        };
+
+        orderBookPayload = cachedRequest("/api/v2/public/get_order_book", "public/get_order_book", params.dump());
+    }
+
+    startRequest("/api/v2/public/get_order_book", *orderBookPayload, std::move(handler));
+}
+
+void Client::startViewCurrentPositions(AsyncRestClient::Handler handler)
+{
+    Payload payload = cachedRequest("/api/v2/private/get_positions", "private/get_positions", "{}");
+    startRequest("/api/v2/private/get_positions", *payload, std::move(handler));
+}
+
 void Client::authenticate()
 {
     nlohmann::json payload = {
@@ -525,33 +926,41 @@ void Client::authenticate()
 
     try
     {
-        connect();
+        if (!_restConnected)
+        {
+            connect();
+        }
+
         nlohmann::json response = sendRequest("/api/v2/public/auth", "POST ", payload);
 
-        if (response.contains("result") && response["result"].contains("access_token")) 
+        if (!response.contains("result") || !response["result"].contains("access_token")) 
         {
-            std::string accessToken = response["result"]["access_token"];
-            setAccessToken(accessToken);
-            spdlog::info("Authenticated successfully. Access token: {}", accessToken);
+            throw std::runtime_error("Authentication failed: " + response.dump());
         }
 
-        spdlog::info("Connected succesfully...");
+        std::string accessToken = response["result"]["access_token"];
+        setAccessToken(accessToken);
+        spdlog::info("Authenticated successfully. Access token: {}", accessToken);
     }
     catch(const std::exception& e)
     {
-        spdlog::info("Something goes wrong : {}", e.what());
+        spdlog::error("Authentication error: {}", e.what());
+        throw;
     }
 }
 
 void Client::initWebSocket()
+{
+    connectWebSocket();
+    authenticateWebSocket();
+}
+
+void Client::connectWebSocket()
 {
     try 
     {
-        boost::asio::ip::tcp::resolver resolver(_io_context_ws);
-        auto results = resolver.resolve(_host, _port);
-
         auto& raw_socket = _ws.next_layer().next_layer();
-        boost::asio::connect(raw_socket, results);
+        boost::asio::connect(raw_socket, endpoints());
 
         _ws.next_layer().handshake(boost::asio::ssl::stream_base::client);
 
@@ -559,8 +968,20 @@ void Client::initWebSocket()
         _ws.handshake(_host, "/ws/api/v2");
 
         spdlog::info("WebSocket connection established with {}", _host);
+    } 
+    catch (const std::exception& ex) 
+    {
+        spdlog::error("WebSocket initialization error: {}", ex.what());
+        throw;
+    }
+}
 
-        nlohmann::json payload = {
+void Client::authenticateWebSocket()
+{
+    try 
+    {
+        ArenaScope scope;
+        ArenaJson payload = {
             {"jsonrpc", "2.0"},
             {"id", 0},
             {"method", "public/auth"},
@@ -571,15 +992,15 @@ void Client::initWebSocket()
             }}
         };
 
-        std::string payload_str = payload.dump();
-        _ws.write(boost::asio::buffer(payload_str));
+        ArenaString payload_str = payload.dump();
+        _ws.write(boost::asio::buffer(payload_str.data(), payload_str.size()));
         spdlog::info("Authentication payload sent: {}", payload_str);
 
         boost::beast::flat_buffer buffer;
         _ws.read(buffer);
 
-        std::string response_str = boost::beast::buffers_to_string(buffer.data());
-        nlohmann::json response = nlohmann::json::parse(response_str);
+        const char* response_data = static_cast<const char*>(buffer.data().data());
+        ArenaJson response = ArenaJson::parse(response_data, response_data + buffer.size());
 
         if (response.contains("result")) 
         {
@@ -594,7 +1015,7 @@ void Client::initWebSocket()
     } 
     catch (const std::exception& ex) 
     {
-        spdlog::error("WebSocket initialization error: {}", ex.what());
+        spdlog::error("WebSocket authentication error: {}", ex.what());
         throw;
     }
 }
@@ -620,6 +1041,30 @@ void Client::subscribeToMarketData(const std::string& symbol)
     }
 }
 
+void Client::subscribeToTrades(const std::string& symbol)
+{
+    try 
+    {
+        nlohmann::json subscribePayload = {
+            {"jsonrpc", "2.0"},
+            {"id", 2},
+            {"method", "public/subscribe"},
+            {"params", {{"channels", {"trades." + symbol + ".raw"}}}}
+        };
+
+        _ws.write(boost::asio::buffer(subscribePayload.dump()));
+
+        // Only instruments with a trade subscription get a tape ring.
+        instrumentState(symbol).tapeSlot = _tradeTape.registerInstrument(symbol);
+        spdlog::info("Subscribed to trades: {}", symbol);
+    } 
+    catch (const std::exception& e) 
+    {
+        spdlog::error("Trade subscription error: {}", e.what());
+        throw;
+    }
+}
+
 void Client::streamMarketData(const int &seconds)
 {
     try 
@@ -630,9 +1075,21 @@ void Client::streamMarketData(const int &seconds)
         while (true) 
         {
             _ws.read(buffer);
-            std::string message = boost::beast::buffers_to_string(buffer.data());
-            spdlog::info("Market Data Received: {}", message);
-            buffer.clear();
+            // flat_buffer keeps the frame contiguous, so the message is viewed in place
+            // and the buffer's storage is reused for the next read.
+            std::string_view message(static_cast<const char*>(buffer.data().data()), buffer.size());
+            spdlog::trace("Market Data Received: {}", message);
+
+            if (_recording.is_open())
+            {
+                _recording << message << '\n';
+            }
+            auto processingStart = std::chrono::high_resolution_clock::now();
+            handleMarketDataMessage(message);
+            Metrics::increment(Counter::WsMessages);
+            Metrics::increment(Counter::WsBytes, message.size());
+            Metrics::observe(Histogram::MarketDataProcessing, std::chrono::high_resolution_clock::now() - processingStart);
+            buffer.consume(buffer.size());
 
             auto endTimestamp = std::chrono::high_resolution_clock::now();
             auto elapsed_time = std::chrono::duration_cast<std::chrono::seconds>(endTimestamp - startTimestamp).count();
@@ -649,60 +1106,407 @@ void Client::streamMarketData(const int &seconds)
     }
 }
 
-void Client::addToCache(const std::string& key, const std::string& payload)
+void Client::handleMarketDataMessage(std::string_view message)
+{
+    ArenaScope scope;
+
+    try
+    {
+        ArenaJson notification = ArenaJson::parse(message.data(), message.data() + message.size());
+
+        if (notification.contains("id") && notification["id"].is_number_unsigned())
+        {
+            auto pending = _pendingSnapshots.find(notification["id"].get<uint64_t>());
+            if (pending != _pendingSnapshots.end())
+            {
+                std::string instrument = std::move(pending->second);
+                _pendingSnapshots.erase(pending);
+                handleBookSnapshot(instrument, notification);
+            }
+            return;
+        }
+
+        if (!notification.contains("method") || notification["method"] != "subscription")
+        {
+            return;
+        }
+
+        const auto& params = notification["params"];
+        const ArenaString& channel = params["channel"].get_ref<const ArenaString&>();
+
+        if (channel.compare(0, 5, "book.") == 0)
+        {
+            handleBookNotification(params["data"]);
+        }
+        else if (channel.compare(0, 7, "trades.") == 0)
+        {
+            handleTradeNotification(params["data"]);
+        }
+    }
+    catch (const ArenaJson::exception& ex)
+    {
+        spdlog::error("Market data parsing error: {}", ex.what());
+    }
+}
+
+void Client::handleBookNotification(const ArenaJson& data)
+{
+    parseBookNotification(data, _bookUpdate);
+
+    InstrumentState& state = instrumentState(_bookUpdate.instrument_name);
+
+    if (state.resyncing)
+    {
+        bufferBookDelta(state, _bookUpdate);
+        return;
+    }
+
+    if (!_bookUpdate.is_snapshot && (state.book.changeId() == 0 || _bookUpdate.prev_change_id != state.book.changeId()))
+    {
+        spdlog::warn("Book sequence gap on {}: expected prev_change_id {}, got {}. Resyncing from snapshot.",
+            _bookUpdate.instrument_name, state.book.changeId(), _bookUpdate.prev_change_id);
+        Metrics::increment(Counter::BookGaps);
+
+        state.resyncing = true;
+        bufferBookDelta(state, _bookUpdate);
+        requestBookSnapshot(_bookUpdate.instrument_name);
+        return;
+    }
+
+    state.book.apply(_bookUpdate);
+
+    if (state.analyticsSlot >= 0)
+    {
+        _analytics.apply(static_cast<size_t>(state.analyticsSlot), _bookUpdate, state.book);
+    }
+
+    if (_paperExchange)
+    {
+        _paperExchange->onBook(_bookUpdate);
+    }
+
+    uint32_t changes = 0;
+    if (!_bookUpdate.bids.empty()) changes |= MarketDataConflator::BidsChanged;
+    if (!_bookUpdate.asks.empty()) changes |= MarketDataConflator::AsksChanged;
+    publishBook(state, changes);
+}
+
+void Client::handleBookSnapshot(const std::string& instrument_name, const ArenaJson& response)
+{
+    InstrumentState& state = instrumentState(instrument_name);
+
+    if (!response.contains("result"))
+    {
+        // Leave the book empty; the next delta fails the sequence check and asks again.
+        spdlog::error("Order book snapshot for {} failed: {}", instrument_name, response.dump());
+        state.book.clear();
+        state.resyncing = false;
+        state.pendingDeltas.clear();
+
+        if (state.analyticsSlot >= 0)
+        {
+            _analytics.rebuild(static_cast<size_t>(state.analyticsSlot), state.book);
+        }
+
+        Metrics::setGauge(Gauge::BufferedBookDeltas, static_cast<int64_t>(bufferedBookDeltas()));
+        // Consumers must not keep reading the pre-gap book as if it were valid.
+        publishBook(state, MarketDataConflator::BidsChanged | MarketDataConflator::AsksChanged | MarketDataConflator::Resynced);
+        return;
+    }
+
+    parseBookSnapshot(instrument_name, response["result"], _bookUpdate);
+    state.book.apply(_bookUpdate);
+
+    if (_paperExchange)
+    {
+        _paperExchange->onBook(_bookUpdate);
+    }
+
+    size_t replayed = 0;
+    size_t next = 0;
+    for (; next < state.pendingDeltas.size(); ++next)
+    {
+        const BookUpdate& delta = state.pendingDeltas[next];
+        if (!delta.is_snapshot && delta.change_id <= state.book.changeId())
+        {
+            continue;
+        }
+
+        if (!delta.is_snapshot && delta.prev_change_id != state.book.changeId())
+        {
+            break;
+        }
+
+        state.book.apply(delta);
+
+        if (_paperExchange)
+        {
+            _paperExchange->onBook(delta);
+        }
+        ++replayed;
+    }
+
+    if (next < state.pendingDeltas.size())
+    {
+        // The snapshot is older than the gap we buffered across; keep the tail and ask again.
+        spdlog::warn("Snapshot for {} at change_id {} does not bridge buffered deltas. Requesting another.",
+            instrument_name, state.book.changeId());
+        state.pendingDeltas.erase(state.pendingDeltas.begin(), state.pendingDeltas.begin() + static_cast<std::ptrdiff_t>(next));
+        requestBookSnapshot(instrument_name);
+        Metrics::setGauge(Gauge::BufferedBookDeltas, static_cast<int64_t>(bufferedBookDeltas()));
+        return;
+    }
+
+    state.pendingDeltas.clear();
+    state.resyncing = false;
+    Metrics::increment(Counter::BookResyncs);
+
+    if (state.analyticsSlot >= 0)
+    {
+        _analytics.rebuild(static_cast<size_t>(state.analyticsSlot), state.book);
+    }
+
+    Metrics::setGauge(Gauge::BufferedBookDeltas, static_cast<int64_t>(bufferedBookDeltas()));
+    spdlog::info("Resynced {} at change_id {} ({} buffered deltas replayed).", instrument_name, state.book.changeId(), replayed);
+
+    publishBook(state, MarketDataConflator::BidsChanged | MarketDataConflator::AsksChanged | MarketDataConflator::Resynced);
+}
+
+void Client::requestBookSnapshot(const std::string& instrument_name)
+{
+    for (auto it = _pendingSnapshots.begin(); it != _pendingSnapshots.end();)
+    {
+        it = it->second == instrument_name ? _pendingSnapshots.erase(it) : std::next(it);
+    }
+
+    ArenaScope scope;
+    uint64_t requestId = _nextRequestId++;
+    ArenaJson snapshotPayload = {
+        {"jsonrpc", "2.0"},
+        {"id", requestId},
+        {"method", "public/get_order_book"},
+        {"params", {
+            {"instrument_name", instrument_name},
+            {"depth", max_snapshot_depth}
+        }}
+    };
+
+    try
+    {
+        ArenaString snapshot_str = snapshotPayload.dump();
+        _ws.write(boost::asio::buffer(snapshot_str.data(), snapshot_str.size()));
+        _pendingSnapshots.emplace(requestId, instrument_name);
+    }
+    catch (const std::exception& e)
+    {
+        spdlog::error("Order book snapshot request for {} failed: {}", instrument_name, e.what());
+    }
+}
+
+void Client::bufferBookDelta(InstrumentState& state, const BookUpdate& update)
+{
+    if (state.pendingDeltas.size() >= max_buffered_deltas)
+    {
+        spdlog::warn("Resync buffer for {} overflowed. Dropping buffered deltas and requesting a fresh snapshot.", update.instrument_name);
+        state.pendingDeltas.clear();
+        state.pendingDeltas.push_back(update);
+        requestBookSnapshot(update.instrument_name);
+    }
+    else
+    {
+        state.pendingDeltas.push_back(update);
+    }
+
+    Metrics::setGauge(Gauge::BufferedBookDeltas, static_cast<int64_t>(bufferedBookDeltas()));
+}
+
+size_t Client::bufferedBookDeltas() const
+{
+    size_t buffered = 0;
+    for (const auto& [instrument, state] : _instruments)
+    {
+        buffered += state.pendingDeltas.size();
+    }
+    return buffered;
+}
+
+void Client::publishBook(InstrumentState& state, uint32_t changes)
+{
+    state.book.fillTop(_bookTop);
+
+    if (state.conflatorSlot >= 0)
+    {
+        _conflator.publish(static_cast<size_t>(state.conflatorSlot), _bookTop, changes);
+    }
+
+    if (_shmPublisher && state.shmSlot >= 0)
+    {
+        _shmPublisher->publishBook(state.shmSlot, _bookTop);
+    }
+}
+
+void Client::handleTradeNotification(const ArenaJson& data)
+{
+    for (const auto& print : data)
+    {
+        Trade trade = parseTrade(print);
+        const ArenaString& instrument = print["instrument_name"].get_ref<const ArenaString&>();
+        _instrumentName.assign(instrument.data(), instrument.size());
+
+        InstrumentState& state = instrumentState(_instrumentName);
+        _tradeTape.append(state.tapeSlot, trade);
+
+        if (_paperExchange)
+        {
+            _paperExchange->onTrade(_instrumentName, trade);
+        }
+
+        if (_shmPublisher && state.shmSlot >= 0)
+        {
+            _shmPublisher->publishTrade(state.shmSlot, trade);
+        }
+    }
+}
+
+Client::InstrumentState& Client::instrumentState(const std::string& instrument_name)
 {
-    if (payload.size() > max_payload_size) 
+    auto it = _instruments.find(instrument_name);
+    if (it == _instruments.end())
+    {
+        it = _instruments.emplace(instrument_name, InstrumentState()).first;
+        it->second.conflatorSlot = _conflator.registerInstrument(instrument_name);
+        it->second.analyticsSlot = _analytics.registerInstrument(instrument_name);
+
+        if (_shmPublisher)
+        {
+            it->second.shmSlot = _shmPublisher->registerInstrument(instrument_name);
+        }
+
+        Metrics::setGauge(Gauge::TrackedInstruments, static_cast<int64_t>(_instruments.size()));
+    }
+
+    return it->second;
+}
+
+MarketDataConflator& Client::conflator()
+{
+    return _conflator;
+}
+
+TradeTape& Client::tradeTape()
+{
+    return _tradeTape;
+}
+
+BookAnalytics& Client::analytics()
+{
+    return _analytics;
+}
+
+void Client::enableSharedMemoryPublisher(const std::string& segment_name)
+{
+    try
+    {
+        _shmPublisher = std::make_unique<ShmBookPublisher>(segment_name);
+
+        for (auto& [instrument, state] : _instruments)
+        {
+            state.shmSlot = _shmPublisher->registerInstrument(instrument);
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        spdlog::error("Shared memory publisher disabled: {}", ex.what());
+    }
+}
+
+void Client::addToCache(const std::string& key, const Payload& payload)
+{
+    if (payload->size() > max_payload_size) 
     {
         spdlog::warn("Payload size exceeds the maximum limit of {} characters. Skipping cache.", max_payload_size);
         return;
     }
 
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+
     if (payload_cache.find(key) != payload_cache.end()) 
     {
         cache_keys.remove(key);
     } 
     else if (cache_keys.size() >= max_cache_size) 
     {
-        std::string lru_key = cache_keys.front();
+        payload_cache.erase(cache_keys.front());
         cache_keys.pop_front();
-        payload_cache.erase(lru_key);
     }
 
     cache_keys.push_back(key);
     payload_cache[key] = payload;
 }
 
-std::string Client::getFromCache(const std::string& key)
+Client::Payload Client::getFromCache(const std::string& key)
 {
-    if (payload_cache.find(key) != payload_cache.end()) 
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+
+    auto it = payload_cache.find(key);
+    if (it != payload_cache.end()) 
     {
-        cache_keys.remove(key);
-        cache_keys.push_back(key);
-        return payload_cache[key];
+        auto position = std::find(cache_keys.begin(), cache_keys.end(), key);
+        cache_keys.splice(cache_keys.end(), cache_keys, position);
+        Metrics::increment(Counter::CacheHits);
+        return it->second;
     }
-    return "";
+
+    Metrics::increment(Counter::CacheMisses);
+    return nullptr;
 }
 
-nlohmann::json Client::getCachedPayload(const std::string& endpoint, const std::string& method, const nlohmann::json& params)
+Client::Payload Client::cachedRequest(const std::string& endpoint, const std::string& method, std::string_view params)
 {
-    std::string key = endpoint + ":" + method + ":" + params.dump();
+    // The key lives in a per-thread buffer, so a cache hit costs one lookup and
+    // a reference count increment, with no allocation.
+    thread_local std::string key;
 
-    std::string cached_payload = getFromCache(key);
-    if (!cached_payload.empty()) 
+    key.clear();
+    key.append(endpoint).append(":").append(method).append(":").append(params);
+
+    if (Payload cached_payload = getFromCache(key)) 
     {
-        spdlog::info("Using cached payload for key: {}", key);
-        return nlohmann::json::parse(cached_payload);
+        spdlog::debug("Using cached payload for key: {}", key);
+        return cached_payload;
     }
 
-    nlohmann::json payload = {
-        {"jsonrpc", "2.0"},
-        {"id", 1},
-        {"method", method},
-        {"params", params}
-    };
+    auto payload = std::make_shared<std::string>();
+    payload->append(R"({"id":1,"jsonrpc":"2.0","method":")").append(method)
+            .append(R"(","params":)").append(params).append("}");
 
-    addToCache(key, payload.dump());
-    spdlog::info("Added new payload to cache for key: {}", key);
+    addToCache(key, payload);
+    spdlog::debug("Added new payload to cache for key: {}", key);
 
     return payload;
 }
+
+nlohmann::json Client::getCachedPayload(const std::string& endpoint, const std::string& method, const nlohmann::json& params)
+{
+    return nlohmann::json::parse(*cachedRequest(endpoint, method, params.dump()));
+}
+
+ArenaJson Client::parseArenaResponse(std::string_view body)
+{
+    if (body.empty())
+    {
+        return ArenaJson();
+    }
+
+    try 
+    {
+        return ArenaJson::parse(body.data(), body.data() + body.size());
+    } 
+    catch (const ArenaJson::exception& ex)
+    {
+        spdlog::error("JSON parsing error: {}", ex.what());
+        Metrics::increment(Counter::RestErrors);
+    }
+
+    return ArenaJson();
+}
@@ -0,0 +1,169 @@
+#include "MarketDataConflator.hpp"
+#include "Metrics.hpp"
+#include <spdlog/spdlog.h>
+
+MarketDataConflator::MarketDataConflator()
+    : _slots(new Slot[max_instruments]), _consumers(new Consumer[max_consumers])
+{
+}
+
+int MarketDataConflator::registerInstrument(const std::string& instrument_name)
+{
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+
+    auto it = _instrumentIndex.find(instrument_name);
+    if (it != _instrumentIndex.end())
+    {
+        return static_cast<int>(it->second);
+    }
+
+    size_t index = _instrumentCount.load(std::memory_order_relaxed);
+    if (index >= max_instruments)
+    {
+        spdlog::warn("Conflator is full ({} instruments). {} will not be conflated.", max_instruments, instrument_name);
+        return -1;
+    }
+
+    _slots[index].instrument_name = instrument_name;
+    _instrumentIndex.emplace(instrument_name, index);
+    _instrumentCount.store(index + 1, std::memory_order_release);
+    return static_cast<int>(index);
+}
+
+int MarketDataConflator::findInstrument(const std::string& instrument_name)
+{
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+
+    auto it = _instrumentIndex.find(instrument_name);
+    return it == _instrumentIndex.end() ? -1 : static_cast<int>(it->second);
+}
+
+int MarketDataConflator::registerConsumer()
+{
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+
+    for (size_t i = 0; i < max_consumers; ++i)
+    {
+        Consumer& consumer = _consumers[i];
+        if (consumer.active.load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        size_t count = _instrumentCount.load(std::memory_order_relaxed);
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            consumer.last_count[slot] = _slots[slot].publish_count.load(std::memory_order_relaxed);
+            consumer.changes[slot].store(0, std::memory_order_relaxed);
+        }
+        for (auto& word : consumer.dirty)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+
+        consumer.active.store(true, std::memory_order_release);
+        Metrics::setGauge(Gauge::ConflationConsumers, static_cast<int64_t>(activeConsumers()));
+        return static_cast<int>(i);
+    }
+
+    spdlog::warn("No free conflation consumer slots (max {}).", max_consumers);
+    return -1;
+}
+
+void MarketDataConflator::unregisterConsumer(int consumer_id)
+{
+    if (consumer_id < 0 || static_cast<size_t>(consumer_id) >= max_consumers)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_registrationMutex);
+    _consumers[consumer_id].active.store(false, std::memory_order_release);
+    Metrics::setGauge(Gauge::ConflationConsumers, static_cast<int64_t>(activeConsumers()));
+}
+
+void MarketDataConflator::publish(size_t instrument_index, const BookTop& top, uint32_t changes)
+{
+    Slot& slot = _slots[instrument_index];
+    slot.book.store(top);
+    slot.publish_count.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t bit = uint64_t(1) << (instrument_index % 64);
+    const size_t word = instrument_index / 64;
+
+    for (size_t i = 0; i < max_consumers; ++i)
+    {
+        Consumer& consumer = _consumers[i];
+        if (!consumer.active.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        consumer.changes[instrument_index].fetch_or(changes, std::memory_order_relaxed);
+        consumer.dirty[word].fetch_or(bit, std::memory_order_release);
+    }
+}
+
+size_t MarketDataConflator::poll(int consumer_id, std::vector<ConflatedUpdate>& out)
+{
+    out.clear();
+    if (consumer_id < 0 || static_cast<size_t>(consumer_id) >= max_consumers)
+    {
+        return 0;
+    }
+
+    Consumer& consumer = _consumers[consumer_id];
+    const size_t words = (instrumentCount() + 63) / 64;
+
+    uint64_t conflated = 0;
+    for (size_t word = 0; word < words; ++word)
+    {
+        uint64_t bits = consumer.dirty[word].exchange(0, std::memory_order_acquire);
+        while (bits)
+        {
+            size_t index = word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+
+            Slot& slot = _slots[index];
+            ConflatedUpdate update;
+            update.instrument_index = index;
+            update.instrument_name = &slot.instrument_name;
+            update.changes = consumer.changes[index].exchange(0, std::memory_order_relaxed);
+            slot.book.load(update.top);
+
+            uint64_t count = slot.publish_count.load(std::memory_order_relaxed);
+            update.updates_conflated = count - consumer.last_count[index];
+            consumer.last_count[index] = count;
+            conflated += update.updates_conflated > 1 ? update.updates_conflated - 1 : 0;
+
+            out.push_back(update);
+        }
+    }
+
+    if (conflated)
+    {
+        Metrics::increment(Counter::ConflatedUpdates, conflated);
+    }
+    return out.size();
+}
+
+size_t MarketDataConflator::activeConsumers() const
+{
+    size_t active = 0;
+    for (size_t i = 0; i < max_consumers; ++i)
+    {
+        active += _consumers[i].active.load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    return active;
+}
+
+bool MarketDataConflator::latest(size_t instrument_index, BookTop& out) const
+{
+    if (instrument_index >= instrumentCount())
+    {
+        return false;
+    }
+
+    _slots[instrument_index].book.load(out);
+    return true;
+}
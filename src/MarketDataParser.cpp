@@ -0,0 +1,65 @@
+#include "MarketDataParser.hpp"
+#include <cstdlib>
+
+using json = ArenaJson;
+
+void parseBookNotification(const json& data, BookUpdate& out)
+{
+    auto parseLevels = [](const json& levels, std::vector<BookLevelChange>& changes) {
+        for (const auto& level : levels)
+        {
+            const ArenaString& action = level[0].get_ref<const ArenaString&>();
+            BookLevelChange change;
+            change.action = action == "delete" ? BookLevelChange::Action::Delete
+                          : action == "new"    ? BookLevelChange::Action::New
+                                               : BookLevelChange::Action::Change;
+            change.price = level[1].get<double>();
+            change.amount = level[2].get<double>();
+            changes.push_back(change);
+        }
+    };
+
+    out.clear();
+    const ArenaString& instrument = data["instrument_name"].get_ref<const ArenaString&>();
+    out.instrument_name.assign(instrument.data(), instrument.size());
+    out.timestamp = data.value("timestamp", int64_t(0));
+    out.change_id = data.value("change_id", uint64_t(0));
+    out.prev_change_id = data.value("prev_change_id", uint64_t(0));
+    auto type = data.find("type");
+    out.is_snapshot = type != data.end() && *type == "snapshot";
+    parseLevels(data["bids"], out.bids);
+    parseLevels(data["asks"], out.asks);
+}
+
+void parseBookSnapshot(const std::string& instrument_name, const json& result, BookUpdate& out)
+{
+    auto parseLevels = [](const json& levels, std::vector<BookLevelChange>& changes) {
+        for (const auto& level : levels)
+        {
+            changes.push_back({BookLevelChange::Action::New, level[0].get<double>(), level[1].get<double>()});
+        }
+    };
+
+    out.clear();
+    out.instrument_name = instrument_name;
+    out.timestamp = result.value("timestamp", int64_t(0));
+    out.change_id = result["change_id"].get<uint64_t>();
+    out.is_snapshot = true;
+    parseLevels(result["bids"], out.bids);
+    parseLevels(result["asks"], out.asks);
+}
+
+Trade parseTrade(const json& print)
+{
+    Trade trade;
+    trade.timestamp = print["timestamp"].get<int64_t>();
+    trade.price = print["price"].get<double>();
+    trade.amount = print["amount"].get<double>();
+    trade.direction = print["direction"] == "buy" ? Trade::Buy : Trade::Sell;
+
+    // Deribit trade ids are decimal strings, optionally prefixed with the currency ("ETH-123").
+    const ArenaString& tradeId = print["trade_id"].get_ref<const ArenaString&>();
+    size_t digits = tradeId.find_last_not_of("0123456789");
+    trade.trade_id = std::strtoull(tradeId.c_str() + (digits == ArenaString::npos ? 0 : digits + 1), nullptr, 10);
+    return trade;
+}
@@ -0,0 +1,49 @@
+#include "MessageArena.hpp"
+#include <algorithm>
+
+thread_local int ArenaScope::_depth = 0;
+
+MessageArena& MessageArena::local()
+{
+    thread_local MessageArena arena;
+    return arena;
+}
+
+void* MessageArena::allocateSlow(size_t bytes, size_t alignment)
+{
+    // Move on to the next retained chunk that fits before growing.
+    size_t next = _chunks.empty() ? 0 : _current + 1;
+    for (; next < _chunks.size(); ++next)
+    {
+        if (bytes + alignment <= _chunks[next].size)
+        {
+            break;
+        }
+    }
+
+    if (next == _chunks.size())
+    {
+        size_t size = std::max(chunk_size, bytes + alignment);
+        _chunks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    }
+    else if (next != _current + 1 && !_chunks.empty())
+    {
+        // Skipped chunks stay unused until the next reset; keep them in order.
+        std::swap(_chunks[_current + 1], _chunks[next]);
+        next = _current + 1;
+    }
+
+    _current = next;
+    _offset = 0;
+    return allocate(bytes, alignment);
+}
+
+size_t MessageArena::reserved() const
+{
+    size_t total = 0;
+    for (const auto& chunk : _chunks)
+    {
+        total += chunk.size;
+    }
+    return total;
+}
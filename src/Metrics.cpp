@@ -0,0 +1,321 @@
+#include "Metrics.hpp"
+#include <cmath>
+#include <sstream>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+    struct MetricInfo {
+        const char* name;
+        const char* help;
+    };
+
+    constexpr MetricInfo counterInfo[] = {
+        {"derbit_rest_requests_total", "REST requests sent"},
+        {"derbit_rest_errors_total", "REST requests that failed or returned unparsable data"},
+        {"derbit_ws_messages_total", "WebSocket messages received"},
+        {"derbit_ws_bytes_total", "WebSocket payload bytes received"},
+        {"derbit_orders_placed_total", "Orders accepted by the exchange"},
+        {"derbit_orders_cancelled_total", "Orders cancelled"},
+        {"derbit_orders_modified_total", "Orders modified"},
+        {"derbit_order_errors_total", "Order operations rejected or failed"},
+        {"derbit_reconnects_total", "REST reconnects triggered by the ping loop"},
+        {"derbit_payload_cache_hits_total", "Payload cache hits"},
+        {"derbit_payload_cache_misses_total", "Payload cache misses"},
+        {"derbit_conflated_updates_total", "Book updates collapsed by the conflator before a consumer read them"},
+        {"derbit_book_gaps_total", "Book sequence gaps detected from change_id/prev_change_id"},
+        {"derbit_book_resyncs_total", "Books rebuilt from a snapshot after a gap"},
+        {"derbit_amendments_coalesced_total", "Order amendments superseded before they were sent"},
+        {"derbit_amendments_dropped_total", "Order amendments discarded because a cancel was pending"},
+        {"derbit_tls_sessions_resumed_total", "TLS handshakes that resumed a cached session"},
+        {"derbit_analytics_recomputes_total", "Book sides whose top-N analytics were recomputed rather than updated in place"},
+        {"derbit_token_refresh_failures_total", "Background access token refreshes that failed and were retried"},
+    };
+
+    constexpr MetricInfo gaugeInfo[] = {
+        {"derbit_tracked_instruments", "Instruments with a local order book"},
+        {"derbit_open_orders", "Orders tracked as open"},
+        {"derbit_conflation_consumers", "Registered conflation consumers"},
+        {"derbit_buffered_book_deltas", "Book deltas buffered while waiting for a resync snapshot"},
+        {"derbit_async_requests_in_flight", "Asynchronous REST requests queued or awaiting a response"},
+        {"derbit_account_sessions", "Account sessions attached to the shared runtime"},
+        {"derbit_public_channels", "Public channels subscribed on the shared market data feed"},
+        {"derbit_ws_write_queue_depth", "WebSocket messages waiting to be written on the shared market data feed"},
+        {"derbit_rest_queue_depth", "Asynchronous REST requests waiting for a pooled connection"},
+    };
+
+    constexpr MetricInfo histogramInfo[] = {
+        {"derbit_rest_request_duration_seconds", "REST round trip latency"},
+        {"derbit_market_data_processing_seconds", "Time spent handling one market data message"},
+    };
+
+    static_assert(sizeof(counterInfo) / sizeof(counterInfo[0]) == static_cast<size_t>(Counter::Count), "Missing counter metadata");
+    static_assert(sizeof(gaugeInfo) / sizeof(gaugeInfo[0]) == static_cast<size_t>(Gauge::Count), "Missing gauge metadata");
+    static_assert(sizeof(histogramInfo) / sizeof(histogramInfo[0]) == static_cast<size_t>(Histogram::Count), "Missing histogram metadata");
+
+    constexpr double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+    inline void bump(std::atomic<uint64_t>& value, uint64_t delta)
+    {
+        // Each shard has a single writer, so a plain load/store avoids a locked RMW.
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    double bucketUpperBound(size_t bucket)
+    {
+        return std::ldexp(1e-6, static_cast<int>(bucket));
+    }
+
+    double estimateQuantile(const std::array<uint64_t, Metrics::histogram_buckets>& buckets, uint64_t count, double q)
+    {
+        if (count == 0)
+        {
+            return 0.0;
+        }
+
+        double target = q * static_cast<double>(count);
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            if (buckets[i] == 0 || static_cast<double>(seen + buckets[i]) < target)
+            {
+                seen += buckets[i];
+                continue;
+            }
+
+            if (i + 1 == buckets.size())
+            {
+                return bucketUpperBound(i - 1);
+            }
+
+            double lower = i == 0 ? 0.0 : bucketUpperBound(i - 1);
+            double upper = bucketUpperBound(i);
+            double fraction = (target - static_cast<double>(seen)) / static_cast<double>(buckets[i]);
+            return lower + (upper - lower) * fraction;
+        }
+
+        return bucketUpperBound(buckets.size() - 2);
+    }
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::ThreadShard& Metrics::localShard()
+{
+    thread_local std::shared_ptr<ThreadShard> shard = [] {
+        auto created = std::make_shared<ThreadShard>();
+        Metrics& metrics = instance();
+        std::lock_guard<std::mutex> lock(metrics._shardsMutex);
+        metrics._shards.push_back(created);
+        return created;
+    }();
+
+    return *shard;
+}
+
+void Metrics::increment(Counter counter, uint64_t value)
+{
+    bump(localShard().counters[static_cast<size_t>(counter)], value);
+}
+
+void Metrics::setGauge(Gauge gauge, int64_t value)
+{
+    instance()._gauges[static_cast<size_t>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::observe(Histogram histogram, std::chrono::nanoseconds duration)
+{
+    uint64_t ns = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+    uint64_t micros = ns / 1000;
+
+    size_t bucket = micros == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(micros));
+    if (bucket >= histogram_buckets)
+    {
+        bucket = histogram_buckets - 1;
+    }
+
+    HistogramShard& shard = localShard().histograms[static_cast<size_t>(histogram)];
+    bump(shard.buckets[bucket], 1);
+    bump(shard.count, 1);
+    bump(shard.sum_ns, ns);
+}
+
+std::string Metrics::renderPrometheus()
+{
+    constexpr size_t counters = static_cast<size_t>(Counter::Count);
+    constexpr size_t histograms = static_cast<size_t>(Histogram::Count);
+
+    std::array<uint64_t, counters> counterTotals{};
+    std::array<std::array<uint64_t, histogram_buckets>, histograms> bucketTotals{};
+    std::array<uint64_t, histograms> countTotals{};
+    std::array<uint64_t, histograms> sumTotals{};
+
+    Metrics& metrics = instance();
+    {
+        std::lock_guard<std::mutex> lock(metrics._shardsMutex);
+        for (const auto& shard : metrics._shards)
+        {
+            for (size_t i = 0; i < counters; ++i)
+            {
+                counterTotals[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+
+            for (size_t h = 0; h < histograms; ++h)
+            {
+                const HistogramShard& histogram = shard->histograms[h];
+                for (size_t b = 0; b < histogram_buckets; ++b)
+                {
+                    bucketTotals[h][b] += histogram.buckets[b].load(std::memory_order_relaxed);
+                }
+                countTotals[h] += histogram.count.load(std::memory_order_relaxed);
+                sumTotals[h] += histogram.sum_ns.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::ostringstream out;
+
+    for (size_t i = 0; i < counters; ++i)
+    {
+        out << "# HELP " << counterInfo[i].name << " " << counterInfo[i].help << "\n"
+            << "# TYPE " << counterInfo[i].name << " counter\n"
+            << counterInfo[i].name << " " << counterTotals[i] << "\n";
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(Gauge::Count); ++i)
+    {
+        out << "# HELP " << gaugeInfo[i].name << " " << gaugeInfo[i].help << "\n"
+            << "# TYPE " << gaugeInfo[i].name << " gauge\n"
+            << gaugeInfo[i].name << " " << metrics._gauges[i].load(std::memory_order_relaxed) << "\n";
+    }
+
+    for (size_t h = 0; h < histograms; ++h)
+    {
+        const char* name = histogramInfo[h].name;
+        out << "# HELP " << name << " " << histogramInfo[h].help << "\n"
+            << "# TYPE " << name << " summary\n";
+
+        for (double q : quantiles)
+        {
+            out << name << "{quantile=\"" << q << "\"} " << estimateQuantile(bucketTotals[h], countTotals[h], q) << "\n";
+        }
+
+        out << name << "_sum " << static_cast<double>(sumTotals[h]) / 1e9 << "\n"
+            << name << "_count " << countTotals[h] << "\n";
+    }
+
+    return out.str();
+}
+
+MetricsServer::MetricsServer(unsigned short port)
+    : _io_context(), _acceptor(_io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port))
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+void MetricsServer::start()
+{
+    accept();
+    _thread = std::thread([this]() {
+        _io_context.run();
+    });
+
+    spdlog::info("Metrics available on http://127.0.0.1:{}/metrics", _acceptor.local_endpoint().port());
+}
+
+void MetricsServer::stop()
+{
+    _io_context.stop();
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void MetricsServer::accept()
+{
+    _acceptor.async_accept([this](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket) {
+        if (ec)
+        {
+            if (ec != boost::asio::error::operation_aborted)
+            {
+                spdlog::warn("Metrics accept error: {}", ec.message());
+                accept();
+            }
+            return;
+        }
+
+        serve(std::move(socket));
+        accept();
+    });
+}
+
+void MetricsServer::serve(boost::asio::ip::tcp::socket socket)
+{
+    namespace http = boost::beast::http;
+
+    struct Session {
+        boost::beast::tcp_stream stream;
+        boost::beast::flat_buffer buffer;
+        http::request<http::string_body> request;
+        http::response<http::string_body> response;
+
+        explicit Session(boost::asio::ip::tcp::socket socket) : stream(std::move(socket)) {}
+    };
+
+    auto session = std::make_shared<Session>(std::move(socket));
+    session->stream.expires_after(request_timeout);
+
+    http::async_read(session->stream, session->buffer, session->request, [session](boost::system::error_code ec, std::size_t) {
+        if (ec)
+        {
+            if (ec != boost::beast::error::timeout && ec != http::error::end_of_stream)
+            {
+                spdlog::warn("Metrics request error: {}", ec.message());
+            }
+            return;
+        }
+
+        const auto& request = session->request;
+        auto& response = session->response;
+        response.version(request.version());
+        response.keep_alive(false);
+
+        if (request.method() == http::verb::get && request.target() == "/metrics")
+        {
+            response.result(http::status::ok);
+            response.set(http::field::content_type, "text/plain; version=0.0.4");
+            response.body() = Metrics::renderPrometheus();
+        }
+        else
+        {
+            response.result(http::status::not_found);
+            response.set(http::field::content_type, "text/plain");
+            response.body() = "Not found\n";
+        }
+
+        response.prepare_payload();
+        session->stream.expires_after(request_timeout);
+
+        http::async_write(session->stream, response, [session](boost::system::error_code ec, std::size_t) {
+            if (ec)
+            {
+                spdlog::warn("Metrics response error: {}", ec.message());
+            }
+
+            session->stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+        });
+    });
+}
@@ -0,0 +1,194 @@
+#include "OrderAmendmentQueue.hpp"
+#include "Metrics.hpp"
+#include <spdlog/spdlog.h>
+
+OrderAmendmentQueue::OrderAmendmentQueue(EditSender send_edit, CancelSender send_cancel)
+    : _sendEdit(std::move(send_edit)), _sendCancel(std::move(send_cancel))
+{
+}
+
+void OrderAmendmentQueue::amend(const std::string& order_id, double amount, double price)
+{
+    Dispatch dispatch;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cancelled.count(order_id))
+        {
+            spdlog::info("Dropping amendment for {}: order already cancelled.", order_id);
+            Metrics::increment(Counter::AmendmentsDropped);
+            return;
+        }
+
+        OrderSlot& slot = _orders[order_id];
+
+        if (slot.cancel_pending || slot.cancel_sent)
+        {
+            spdlog::info("Dropping amendment for {}: cancel already pending.", order_id);
+            Metrics::increment(Counter::AmendmentsDropped);
+            return;
+        }
+
+        if (slot.amend_pending)
+        {
+            Metrics::increment(Counter::AmendmentsCoalesced);
+        }
+
+        slot.amend_pending = true;
+        slot.amount = amount;
+        slot.price = price;
+
+        if (slot.in_flight)
+        {
+            return;
+        }
+        dispatch = next(order_id, slot);
+    }
+
+    send(dispatch);
+}
+
+void OrderAmendmentQueue::cancel(const std::string& order_id)
+{
+    Dispatch dispatch;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cancelled.count(order_id))
+        {
+            return;
+        }
+
+        OrderSlot& slot = _orders[order_id];
+
+        if (slot.cancel_pending || slot.cancel_sent)
+        {
+            return;
+        }
+
+        if (slot.amend_pending)
+        {
+            slot.amend_pending = false;
+            Metrics::increment(Counter::AmendmentsDropped);
+        }
+
+        slot.cancel_pending = true;
+
+        if (slot.in_flight)
+        {
+            return;
+        }
+        dispatch = next(order_id, slot);
+    }
+
+    send(dispatch);
+}
+
+void OrderAmendmentQueue::setListener(Listener listener)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _listener = std::move(listener);
+}
+
+size_t OrderAmendmentQueue::trackedOrders()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _orders.size();
+}
+
+OrderAmendmentQueue::Dispatch OrderAmendmentQueue::next(const std::string& order_id, OrderSlot& slot)
+{
+    Dispatch dispatch;
+    dispatch.order_id = order_id;
+
+    if (slot.cancel_pending)
+    {
+        slot.cancel_pending = false;
+        slot.cancel_sent = true;
+        slot.in_flight = true;
+        dispatch.action = Action::Cancel;
+    }
+    else if (slot.amend_pending)
+    {
+        slot.amend_pending = false;
+        slot.in_flight = true;
+        dispatch.action = Action::Edit;
+        dispatch.amount = slot.amount;
+        dispatch.price = slot.price;
+    }
+
+    return dispatch;
+}
+
+void OrderAmendmentQueue::rememberCancelled(const std::string& order_id)
+{
+    if (!_cancelled.insert(order_id).second)
+    {
+        return;
+    }
+
+    _cancelledOrder.push_back(order_id);
+    if (_cancelledOrder.size() > max_cancelled)
+    {
+        _cancelled.erase(_cancelledOrder.front());
+        _cancelledOrder.pop_front();
+    }
+}
+
+void OrderAmendmentQueue::send(const Dispatch& dispatch)
+{
+    // Senders run outside the lock: their completion may fire synchronously.
+    const std::string orderId = dispatch.order_id;
+
+    if (dispatch.action == Action::Edit)
+    {
+        _sendEdit(orderId, dispatch.amount, dispatch.price, [this, orderId](boost::system::error_code ec, nlohmann::json response) {
+            complete(orderId, false, ec, response);
+        });
+    }
+    else if (dispatch.action == Action::Cancel)
+    {
+        _sendCancel(orderId, [this, orderId](boost::system::error_code ec, nlohmann::json response) {
+            complete(orderId, true, ec, response);
+        });
+    }
+}
+
+void OrderAmendmentQueue::complete(const std::string& order_id, bool was_cancel, boost::system::error_code ec, const nlohmann::json& response)
+{
+    Dispatch dispatch;
+    Listener listener;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        listener = _listener;
+
+        auto it = _orders.find(order_id);
+        if (it != _orders.end())
+        {
+            OrderSlot& slot = it->second;
+            slot.in_flight = false;
+
+            if (was_cancel && (ec || !response.contains("result")))
+            {
+                // The cancel did not take; let later amendments through again.
+                slot.cancel_sent = false;
+            }
+
+            dispatch = next(order_id, slot);
+
+            if (dispatch.action == Action::None)
+            {
+                if (slot.cancel_sent)
+                {
+                    rememberCancelled(order_id);
+                }
+                _orders.erase(it);
+            }
+        }
+    }
+
+    if (listener)
+    {
+        listener(order_id, ec, response);
+    }
+
+    send(dispatch);
+}
@@ -0,0 +1,90 @@
+#include "OrderBook.hpp"
+
+namespace
+{
+    template <typename Side>
+    void applySide(Side& side, const std::vector<BookLevelChange>& changes)
+    {
+        for (const auto& change : changes)
+        {
+            if (change.action == BookLevelChange::Action::Delete || change.amount == 0.0)
+            {
+                side.erase(change.price);
+            }
+            else
+            {
+                side[change.price] = change.amount;
+            }
+        }
+    }
+
+    template <typename Side>
+    uint32_t copySide(const Side& side, double* prices, double* amounts)
+    {
+        uint32_t count = 0;
+        for (auto it = side.begin(); it != side.end() && count < BookTop::max_depth; ++it, ++count)
+        {
+            prices[count] = it->first;
+            amounts[count] = it->second;
+        }
+
+        for (uint32_t i = count; i < BookTop::max_depth; ++i)
+        {
+            prices[i] = 0.0;
+            amounts[i] = 0.0;
+        }
+        return count;
+    }
+}
+
+void BookUpdate::clear()
+{
+    instrument_name.clear();
+    timestamp = 0;
+    change_id = 0;
+    prev_change_id = 0;
+    is_snapshot = false;
+    bids.clear();
+    asks.clear();
+}
+
+void OrderBook::apply(const BookUpdate& update)
+{
+    if (update.is_snapshot)
+    {
+        clear();
+    }
+
+    applySide(_bids, update.bids);
+    applySide(_asks, update.asks);
+    _changeId = update.change_id;
+    _timestamp = update.timestamp;
+}
+
+void OrderBook::clear()
+{
+    _bids.clear();
+    _asks.clear();
+    _changeId = 0;
+    _timestamp = 0;
+}
+
+void OrderBook::fillTop(BookTop& top) const
+{
+    top.timestamp = _timestamp;
+    top.change_id = _changeId;
+    top.bid_count = copySide(_bids, top.bid_prices, top.bid_amounts);
+    top.ask_count = copySide(_asks, top.ask_prices, top.ask_amounts);
+}
+
+double OrderBook::bidAmount(double price) const
+{
+    auto it = _bids.find(price);
+    return it == _bids.end() ? 0.0 : it->second;
+}
+
+double OrderBook::askAmount(double price) const
+{
+    auto it = _asks.find(price);
+    return it == _asks.end() ? 0.0 : it->second;
+}
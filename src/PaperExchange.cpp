@@ -0,0 +1,618 @@
+#include "PaperExchange.hpp"
+#include "MarketDataParser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+namespace
+{
+    constexpr double amount_epsilon = 1e-9;
+
+    struct RequestError : public std::runtime_error {
+        int code;
+
+        RequestError(int errorCode, const std::string& message)
+            : std::runtime_error(message), code(errorCode)
+        {
+        }
+    };
+}
+
+json PaperExchange::handleRequest(const json& payload)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    json id = payload.value("id", json(0));
+    const std::string method = payload.value("method", std::string());
+    const json params = payload.contains("params") && payload["params"].is_object() ? payload["params"] : json::object();
+
+    try
+    {
+        json result;
+        if (method == "private/buy")
+        {
+            result = place(1, params);
+        }
+        else if (method == "private/sell")
+        {
+            result = place(-1, params);
+        }
+        else if (method == "private/edit")
+        {
+            result = edit(params);
+        }
+        else if (method == "private/cancel")
+        {
+            result = cancel(params);
+        }
+        else if (method == "private/get_open_orders" || method == "private/get_open_orders_by_instrument")
+        {
+            result = openOrdersLocked(params.value("instrument_name", std::string()));
+        }
+        else
+        {
+            throw RequestError(-32601, "Method not supported by paper exchange: " + method);
+        }
+
+        flushNotifications();
+        return {{"jsonrpc", "2.0"}, {"id", id}, {"result", result}};
+    }
+    catch (const RequestError& ex)
+    {
+        return error(id, ex.code, ex.what());
+    }
+    catch (const json::exception& ex)
+    {
+        return error(id, -32602, ex.what());
+    }
+}
+
+json PaperExchange::place(int direction, const json& params)
+{
+    SimOrder order;
+    order.instrument_name = params.at("instrument_name").get<std::string>();
+    order.order_type = params.value("type", std::string("limit"));
+    order.direction = direction;
+    order.amount = params.at("amount").get<double>();
+    order.price = order.order_type == "market" ? 0.0 : params.at("price").get<double>();
+
+    if (order.amount <= 0.0)
+    {
+        throw RequestError(-32602, "Invalid amount");
+    }
+    if (order.order_type != "limit" && order.order_type != "market")
+    {
+        throw RequestError(-32602, "Unsupported order type: " + order.order_type);
+    }
+
+    order.order_id = "paper-" + std::to_string(_nextOrderId++);
+    order.priority = _nextPriority++;
+    order.creation_timestamp = _now;
+    order.last_update_timestamp = _now;
+
+    json trades = json::array();
+    matchAggressive(order, trades);
+
+    if (order.state == "open")
+    {
+        if (order.order_type == "market")
+        {
+            order.state = "cancelled";
+        }
+        else
+        {
+            const OrderBook& book = _books[order.instrument_name];
+            order.queue_ahead = direction > 0 ? book.bidAmount(order.price) : book.askAmount(order.price);
+        }
+    }
+
+    notifyOrder(order, trades);
+    json result = {{"order", orderJson(order)}, {"trades", trades}};
+
+    if (order.state == "open")
+    {
+        _orders.emplace(order.order_id, std::move(order));
+    }
+
+    return result;
+}
+
+json PaperExchange::edit(const json& params)
+{
+    const std::string orderId = params.at("order_id").get<std::string>();
+    auto it = _orders.find(orderId);
+    if (it == _orders.end())
+    {
+        throw RequestError(10004, "order_not_found");
+    }
+
+    SimOrder& order = it->second;
+    double amount = params.at("amount").get<double>();
+    double price = params.value("price", order.price);
+
+    if (amount <= order.filled + amount_epsilon)
+    {
+        throw RequestError(-32602, "Amount must exceed the filled amount");
+    }
+
+    // Repricing or growing the order sends it to the back of the queue; shrinking keeps priority.
+    bool losesPriority = price != order.price || amount > order.amount;
+    order.amount = amount;
+    order.price = price;
+    order.last_update_timestamp = _now;
+
+    if (losesPriority)
+    {
+        const OrderBook& book = _books[order.instrument_name];
+        order.queue_ahead = order.direction > 0 ? book.bidAmount(price) : book.askAmount(price);
+        order.priority = _nextPriority++;
+    }
+
+    json trades = json::array();
+    matchAggressive(order, trades);
+    notifyOrder(order, trades);
+
+    json result = {{"order", orderJson(order)}, {"trades", trades}};
+    if (order.state != "open")
+    {
+        _orders.erase(it);
+    }
+    return result;
+}
+
+json PaperExchange::cancel(const json& params)
+{
+    const std::string orderId = params.at("order_id").get<std::string>();
+    auto it = _orders.find(orderId);
+    if (it == _orders.end())
+    {
+        throw RequestError(10004, "order_not_found");
+    }
+
+    SimOrder order = std::move(it->second);
+    _orders.erase(it);
+
+    order.state = "cancelled";
+    order.last_update_timestamp = _now;
+    notifyOrder(order, json::array());
+    return orderJson(order);
+}
+
+json PaperExchange::openOrdersLocked(const std::string& instrument_name) const
+{
+    json orders = json::array();
+    for (const auto& [orderId, order] : _orders)
+    {
+        if (instrument_name.empty() || order.instrument_name == instrument_name)
+        {
+            orders.push_back(orderJson(order));
+        }
+    }
+    return orders;
+}
+
+json PaperExchange::openOrders(const std::string& instrument_name) const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return openOrdersLocked(instrument_name);
+}
+
+void PaperExchange::matchAggressive(SimOrder& order, json& trades)
+{
+    OrderBook& book = _books[order.instrument_name];
+    const bool market = order.order_type == "market";
+
+    BookUpdate consumed;
+    consumed.instrument_name = order.instrument_name;
+    consumed.change_id = book.changeId();
+    consumed.timestamp = book.timestamp();
+
+    auto sweep = [&](const auto& side, std::vector<BookLevelChange>& changes, auto crosses) {
+        for (const auto& [price, size] : side)
+        {
+            double remaining = order.amount - order.filled;
+            if (remaining <= amount_epsilon || (!market && !crosses(price)))
+            {
+                break;
+            }
+
+            double take = std::min(size, remaining);
+            fill(order, take, price, "T", trades);
+            changes.push_back({BookLevelChange::Action::Change, price, size - take});
+        }
+    };
+
+    if (order.direction > 0)
+    {
+        sweep(book.asks(), consumed.asks, [&](double price) { return price <= order.price; });
+    }
+    else
+    {
+        sweep(book.bids(), consumed.bids, [&](double price) { return price >= order.price; });
+    }
+
+    // Take the liquidity we consumed out of the local book until the feed replaces it.
+    if (!consumed.bids.empty() || !consumed.asks.empty())
+    {
+        book.apply(consumed);
+    }
+}
+
+void PaperExchange::fill(SimOrder& order, double amount, double price, const char* liquidity, json& trades)
+{
+    if (amount <= amount_epsilon)
+    {
+        return;
+    }
+
+    order.average_price = (order.average_price * order.filled + price * amount) / (order.filled + amount);
+    order.filled += amount;
+    order.last_update_timestamp = _now;
+
+    if (order.amount - order.filled <= amount_epsilon)
+    {
+        order.state = "filled";
+    }
+
+    trades.push_back({
+        {"trade_id", "paper-T" + std::to_string(_nextTradeId++)},
+        {"instrument_name", order.instrument_name},
+        {"order_id", order.order_id},
+        {"order_type", order.order_type},
+        {"direction", order.direction > 0 ? "buy" : "sell"},
+        {"price", price},
+        {"amount", amount},
+        {"liquidity", liquidity},
+        {"state", order.state},
+        {"timestamp", _now}
+    });
+}
+
+void PaperExchange::onBook(const BookUpdate& update)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    _now = std::max(_now, update.timestamp);
+    OrderBook& book = _books[update.instrument_name];
+
+    struct LevelWatch {
+        SimOrder* order;
+        double before;
+    };
+
+    std::vector<LevelWatch> watches;
+    for (auto& [orderId, order] : _orders)
+    {
+        if (order.instrument_name == update.instrument_name)
+        {
+            double before = order.direction > 0 ? book.bidAmount(order.price) : book.askAmount(order.price);
+            watches.push_back({&order, before});
+        }
+    }
+
+    book.apply(update);
+
+    LevelTrades traded;
+    auto tradedIt = _tradedAtLevel.find(update.instrument_name);
+    if (tradedIt != _tradedAtLevel.end())
+    {
+        traded.swap(tradedIt->second);
+        _tradedAtLevel.erase(tradedIt);
+    }
+
+    for (auto& watch : watches)
+    {
+        SimOrder& order = *watch.order;
+        double after = order.direction > 0 ? book.bidAmount(order.price) : book.askAmount(order.price);
+
+        auto level = traded.find({order.direction, order.price});
+        double cancelled = watch.before - after - (level == traded.end() ? 0.0 : level->second);
+
+        if (cancelled > 0.0 && watch.before > 0.0)
+        {
+            order.queue_ahead -= cancelled * order.queue_ahead / watch.before;
+        }
+
+        order.queue_ahead = std::max(0.0, std::min(order.queue_ahead, after));
+    }
+
+    checkCrossed(update.instrument_name);
+    flushNotifications();
+
+    if (_bookListener)
+    {
+        _bookListener(update.instrument_name, book);
+    }
+}
+
+void PaperExchange::checkCrossed(const std::string& instrument_name)
+{
+    const OrderBook& book = _books[instrument_name];
+    std::vector<std::string> done;
+
+    for (auto& [orderId, order] : _orders)
+    {
+        if (order.instrument_name != instrument_name)
+        {
+            continue;
+        }
+
+        // The opposite side trading through our price means we would have been hit.
+        bool crossed = order.direction > 0
+            ? !book.asks().empty() && book.asks().begin()->first <= order.price
+            : !book.bids().empty() && book.bids().begin()->first >= order.price;
+
+        if (crossed)
+        {
+            json trades = json::array();
+            fill(order, order.amount - order.filled, order.price, "M", trades);
+            notifyOrder(order, trades);
+            done.push_back(orderId);
+        }
+    }
+
+    for (const auto& orderId : done)
+    {
+        _orders.erase(orderId);
+    }
+}
+
+void PaperExchange::onTrade(const std::string& instrument_name, const Trade& trade)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    _now = std::max(_now, trade.timestamp);
+
+    // A sell aggressor hits resting bids, a buy aggressor lifts resting offers.
+    std::vector<SimOrder*> reached;
+    for (auto& [orderId, order] : _orders)
+    {
+        if (order.instrument_name != instrument_name || order.direction == trade.direction)
+        {
+            continue;
+        }
+
+        if (order.direction > 0 ? trade.price <= order.price : trade.price >= order.price)
+        {
+            reached.push_back(&order);
+        }
+    }
+
+    if (reached.empty())
+    {
+        return;
+    }
+
+    // Price priority first (better-priced orders would have traded ahead of the print's level), then time.
+    std::sort(reached.begin(), reached.end(), [](const SimOrder* a, const SimOrder* b) {
+        if (a->price != b->price)
+        {
+            return a->direction > 0 ? a->price > b->price : a->price < b->price;
+        }
+        return a->priority < b->priority;
+    });
+
+    double remaining = trade.amount;
+    double queueTaken = 0.0;
+    bool restingAtPrint = false;
+    std::vector<std::string> done;
+
+    for (SimOrder* order : reached)
+    {
+        if (order->price == trade.price)
+        {
+            restingAtPrint = true;
+
+            // Public size ahead of this order that the print has not already taken
+            // from in front of an earlier order at the same level.
+            double ahead = std::max(0.0, order->queue_ahead - queueTaken);
+            double consumed = std::min(ahead, remaining);
+            queueTaken += consumed;
+            remaining -= consumed;
+            order->queue_ahead = std::max(0.0, order->queue_ahead - queueTaken);
+        }
+
+        double amount = std::min(remaining, order->amount - order->filled);
+        if (amount > amount_epsilon)
+        {
+            json trades = json::array();
+            fill(*order, amount, order->price, "M", trades);
+            notifyOrder(*order, trades);
+            remaining -= amount;
+
+            if (order->state != "open")
+            {
+                done.push_back(order->order_id);
+            }
+        }
+    }
+
+    // The public level shrinks by the whole print, whoever we pretend took it.
+    if (restingAtPrint)
+    {
+        _tradedAtLevel[instrument_name][{-trade.direction, trade.price}] += trade.amount;
+    }
+
+    for (const auto& orderId : done)
+    {
+        _orders.erase(orderId);
+    }
+
+    flushNotifications();
+}
+
+size_t PaperExchange::replay(const std::string& path, double speed)
+{
+    std::ifstream inFile(path);
+    if (!inFile)
+    {
+        spdlog::error("Unable to open market data recording: {}", path);
+        throw std::runtime_error("Unable to open market data recording");
+    }
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    int64_t firstTimestamp = -1;
+    size_t replayed = 0;
+
+    auto pace = [&](int64_t timestamp) {
+        if (speed <= 0.0 || timestamp <= 0)
+        {
+            return;
+        }
+        if (firstTimestamp < 0)
+        {
+            firstTimestamp = timestamp;
+        }
+
+        auto offset = std::chrono::duration<double, std::milli>(static_cast<double>(timestamp - firstTimestamp) / speed);
+        std::this_thread::sleep_until(wallStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset));
+    };
+
+    std::string line;
+    std::string instrument_name;
+    while (std::getline(inFile, line))
+    {
+        ArenaScope scope;
+
+        try
+        {
+            ArenaJson message = ArenaJson::parse(line);
+            if (!message.contains("params") || !message["params"].contains("channel"))
+            {
+                continue;
+            }
+
+            const auto& params = message["params"];
+            const ArenaString& channel = params["channel"].get_ref<const ArenaString&>();
+
+            if (channel.compare(0, 5, "book.") == 0)
+            {
+                parseBookNotification(params["data"], _replayUpdate);
+                pace(_replayUpdate.timestamp);
+                onBook(_replayUpdate);
+            }
+            else if (channel.compare(0, 7, "trades.") == 0)
+            {
+                for (const auto& print : params["data"])
+                {
+                    Trade trade = parseTrade(print);
+                    pace(trade.timestamp);
+                    const ArenaString& instrument = print["instrument_name"].get_ref<const ArenaString&>();
+                    instrument_name.assign(instrument.data(), instrument.size());
+                    onTrade(instrument_name, trade);
+                }
+            }
+            else
+            {
+                continue;
+            }
+
+            ++replayed;
+        }
+        catch (const ArenaJson::exception& ex)
+        {
+            spdlog::warn("Skipping unreadable recorded message: {}", ex.what());
+        }
+    }
+
+    spdlog::info("Replayed {} market data messages from {}", replayed, path);
+    return replayed;
+}
+
+void PaperExchange::setOrderListener(Listener listener)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _listener = std::move(listener);
+}
+
+void PaperExchange::setBookListener(BookListener listener)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _bookListener = std::move(listener);
+}
+
+void PaperExchange::notifyOrder(const SimOrder& order, const json& trades)
+{
+    if (!_listener)
+    {
+        return;
+    }
+
+    _notifications.push_back({
+        {"jsonrpc", "2.0"},
+        {"method", "subscription"},
+        {"params", {
+            {"channel", "user.orders." + order.instrument_name + ".raw"},
+            {"data", orderJson(order)}
+        }}
+    });
+
+    if (!trades.empty())
+    {
+        _notifications.push_back({
+            {"jsonrpc", "2.0"},
+            {"method", "subscription"},
+            {"params", {
+                {"channel", "user.trades." + order.instrument_name + ".raw"},
+                {"data", trades}
+            }}
+        });
+    }
+}
+
+void PaperExchange::flushNotifications()
+{
+    // Listeners may call back into handleRequest, so deliver only once the
+    // order map is no longer being iterated.
+    while (!_notifications.empty())
+    {
+        std::vector<json> pending;
+        pending.swap(_notifications);
+
+        for (const auto& notification : pending)
+        {
+            _listener(notification);
+        }
+    }
+}
+
+json PaperExchange::orderJson(const SimOrder& order)
+{
+    json data = {
+        {"order_id", order.order_id},
+        {"instrument_name", order.instrument_name},
+        {"direction", order.direction > 0 ? "buy" : "sell"},
+        {"order_type", order.order_type},
+        {"order_state", order.state},
+        {"amount", order.amount},
+        {"filled_amount", order.filled},
+        {"average_price", order.average_price},
+        {"creation_timestamp", order.creation_timestamp},
+        {"last_update_timestamp", order.last_update_timestamp}
+    };
+
+    if (order.order_type == "market")
+    {
+        data["price"] = "market_price";
+    }
+    else
+    {
+        data["price"] = order.price;
+    }
+
+    return data;
+}
+
+json PaperExchange::error(const json& id, int code, const std::string& message)
+{
+    return {
+        {"jsonrpc", "2.0"},
+        {"id", id},
+        {"error", {{"code", code}, {"message", message}}}
+    };
+}
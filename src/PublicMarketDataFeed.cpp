@@ -0,0 +1,375 @@
+#include "PublicMarketDataFeed.hpp"
+#include "MessageArena.hpp"
+#include "Metrics.hpp"
+#include <algorithm>
+#include <boost/beast/websocket/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+namespace websocket = boost::beast::websocket;
+
+PublicMarketDataFeed::PublicMarketDataFeed(boost::asio::io_context& io_context, boost::asio::ssl::context& ssl_context,
+                                           TlsSessionCache& session_cache, const std::string& host, const std::string& port)
+    : _io_context(io_context), _ssl_context(ssl_context), _sessionCache(session_cache), _host(host), _port(port),
+      _strand(boost::asio::make_strand(io_context)), _resolver(_strand), _retryTimer(_strand)
+{
+}
+
+void PublicMarketDataFeed::start()
+{
+    boost::asio::post(_strand, [this]() {
+        if (_running)
+        {
+            return;
+        }
+
+        _running = true;
+        connect();
+    });
+}
+
+void PublicMarketDataFeed::stop()
+{
+    boost::asio::post(_strand, [this]() {
+        _running = false;
+        _connected = false;
+        ++_generation;
+        _retryTimer.cancel();
+
+        if (_ws)
+        {
+            boost::system::error_code ec;
+            boost::beast::get_lowest_layer(*_ws).socket().close(ec);
+        }
+    });
+}
+
+void PublicMarketDataFeed::connect()
+{
+    uint64_t generation = ++_generation;
+    _connected = false;
+    _writing = false;
+    _writes.clear();
+    Metrics::setGauge(Gauge::WsWriteQueueDepth, 0);
+    _buffer.clear();
+    _ws = std::make_unique<WebSocket>(_strand, _ssl_context);
+
+    SSL* ssl = _ws->next_layer().native_handle();
+    if (!SSL_set_tlsext_host_name(ssl, _host.c_str()))
+    {
+        fail(generation, "SNI setup", boost::system::error_code(static_cast<int>(::ERR_get_error()), boost::asio::error::get_ssl_category()));
+        return;
+    }
+    _sessionCache.resume(ssl);
+
+    _resolver.async_resolve(_host, _port, [this, generation](boost::system::error_code ec, boost::asio::ip::tcp::resolver::results_type results) {
+        if (generation != _generation)
+        {
+            return;
+        }
+
+        if (ec)
+        {
+            fail(generation, "resolve", ec);
+            return;
+        }
+
+        auto& tcp = boost::beast::get_lowest_layer(*_ws);
+        tcp.expires_after(std::chrono::seconds(30));
+        tcp.async_connect(results, [this, generation](boost::system::error_code ec, const boost::asio::ip::tcp::endpoint&) {
+            if (generation != _generation)
+            {
+                return;
+            }
+
+            if (ec)
+            {
+                fail(generation, "connect", ec);
+                return;
+            }
+
+            boost::beast::get_lowest_layer(*_ws).socket().set_option(boost::asio::ip::tcp::no_delay(true), ec);
+            _ws->next_layer().async_handshake(boost::asio::ssl::stream_base::client, [this, generation](boost::system::error_code ec) {
+                if (generation != _generation)
+                {
+                    return;
+                }
+
+                if (ec)
+                {
+                    fail(generation, "TLS handshake", ec);
+                    return;
+                }
+
+                if (SSL_session_reused(_ws->next_layer().native_handle()))
+                {
+                    Metrics::increment(Counter::TlsSessionsResumed);
+                }
+
+                boost::beast::get_lowest_layer(*_ws).expires_never();
+                _ws->set_option(websocket::stream_base::timeout::suggested(boost::beast::role_type::client));
+                _ws->async_handshake(_host, "/ws/api/v2", [this, generation](boost::system::error_code ec) {
+                    if (generation != _generation)
+                    {
+                        return;
+                    }
+
+                    if (ec)
+                    {
+                        fail(generation, "WebSocket handshake", ec);
+                        return;
+                    }
+
+                    _connected = true;
+                    spdlog::info("Shared public market data feed connected to {}", _host);
+
+                    std::vector<std::string> channels;
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        channels.reserve(_channels.size());
+                        for (const auto& [channel, subscribers] : _channels)
+                        {
+                            channels.push_back(channel);
+                        }
+                    }
+
+                    if (!channels.empty())
+                    {
+                        sendSubscription("public/subscribe", channels);
+                    }
+                    read();
+                });
+            });
+        });
+    });
+}
+
+void PublicMarketDataFeed::fail(uint64_t generation, const char* what, boost::system::error_code ec)
+{
+    if (generation != _generation || !_running)
+    {
+        return;
+    }
+
+    spdlog::error("Shared public market data {} failed: {}", what, ec.message());
+    scheduleReconnect();
+}
+
+void PublicMarketDataFeed::scheduleReconnect()
+{
+    ++_generation;
+    _connected = false;
+    Metrics::increment(Counter::Reconnects);
+
+    if (_ws)
+    {
+        boost::system::error_code ec;
+        boost::beast::get_lowest_layer(*_ws).socket().close(ec);
+    }
+
+    _retryTimer.expires_after(std::chrono::seconds(1));
+    _retryTimer.async_wait([this](boost::system::error_code ec) {
+        if (!ec && _running)
+        {
+            connect();
+        }
+    });
+}
+
+void PublicMarketDataFeed::read()
+{
+    uint64_t generation = _generation;
+    _ws->async_read(_buffer, [this, generation](boost::system::error_code ec, std::size_t) {
+        if (ec)
+        {
+            fail(generation, "read", ec);
+            return;
+        }
+
+        if (generation != _generation)
+        {
+            return;
+        }
+
+        dispatch(std::string_view(static_cast<const char*>(_buffer.data().data()), _buffer.size()));
+        _buffer.consume(_buffer.size());
+        read();
+    });
+}
+
+void PublicMarketDataFeed::write(std::string message)
+{
+    _writes.push_back(std::move(message));
+    Metrics::setGauge(Gauge::WsWriteQueueDepth, static_cast<int64_t>(_writes.size()));
+    flush();
+}
+
+void PublicMarketDataFeed::flush()
+{
+    if (!_connected || _writing || _writes.empty())
+    {
+        return;
+    }
+
+    _writing = true;
+    uint64_t generation = _generation;
+    _ws->async_write(boost::asio::buffer(_writes.front()), [this, generation](boost::system::error_code ec, std::size_t) {
+        if (ec)
+        {
+            fail(generation, "write", ec);
+            return;
+        }
+
+        if (generation != _generation)
+        {
+            return;
+        }
+
+        _writing = false;
+        _writes.pop_front();
+        Metrics::setGauge(Gauge::WsWriteQueueDepth, static_cast<int64_t>(_writes.size()));
+        flush();
+    });
+}
+
+void PublicMarketDataFeed::sendSubscription(const char* method, const std::vector<std::string>& channels)
+{
+    nlohmann::json payload = {
+        {"jsonrpc", "2.0"},
+        {"id", _nextRequestId++},
+        {"method", method},
+        {"params", {{"channels", channels}}}
+    };
+
+    write(payload.dump());
+    spdlog::info("Shared public market data {}: {}", method, nlohmann::json(channels).dump());
+}
+
+void PublicMarketDataFeed::dispatch(std::string_view message)
+{
+    ArenaScope scope;
+    Metrics::increment(Counter::WsMessages);
+    Metrics::increment(Counter::WsBytes, message.size());
+
+    try
+    {
+        ArenaJson notification = ArenaJson::parse(message.data(), message.data() + message.size());
+
+        auto method = notification.find("method");
+        if (method == notification.end() || *method != "subscription")
+        {
+            auto error = notification.find("error");
+            if (error != notification.end())
+            {
+                spdlog::error("Shared public market data request failed: {}", error->dump());
+            }
+            return;
+        }
+
+        const ArenaString& channel = notification["params"]["channel"].get_ref<const ArenaString&>();
+        _channel.assign(channel.data(), channel.size());
+    }
+    catch (const ArenaJson::exception& ex)
+    {
+        spdlog::error("Shared public market data parsing error: {}", ex.what());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _channels.find(_channel);
+        if (it == _channels.end())
+        {
+            return;
+        }
+
+        for (const auto& subscriber : it->second)
+        {
+            _dispatch.push_back(subscriber.listener);
+        }
+    }
+
+    for (const auto& listener : _dispatch)
+    {
+        try
+        {
+            (*listener)(_channel, message);
+        }
+        catch (const std::exception& ex)
+        {
+            spdlog::error("Market data listener for {} failed: {}", _channel, ex.what());
+        }
+    }
+    _dispatch.clear();
+}
+
+uint64_t PublicMarketDataFeed::subscribe(const std::string& channel, Listener listener)
+{
+    uint64_t subscription;
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        subscription = _nextSubscription++;
+        auto& subscribers = _channels[channel];
+        first = subscribers.empty();
+        subscribers.push_back({subscription, std::make_shared<const Listener>(std::move(listener))});
+        _subscriptions.emplace(subscription, channel);
+        Metrics::setGauge(Gauge::PublicChannels, static_cast<int64_t>(_channels.size()));
+    }
+
+    if (first)
+    {
+        boost::asio::post(_strand, [this, channel]() {
+            if (_connected)
+            {
+                sendSubscription("public/subscribe", {channel});
+            }
+        });
+    }
+
+    return subscription;
+}
+
+void PublicMarketDataFeed::unsubscribe(uint64_t subscription)
+{
+    std::string channel;
+    bool last = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _subscriptions.find(subscription);
+        if (it == _subscriptions.end())
+        {
+            return;
+        }
+
+        channel = std::move(it->second);
+        _subscriptions.erase(it);
+
+        auto& subscribers = _channels[channel];
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+            [subscription](const Subscriber& subscriber) { return subscriber.id == subscription; }), subscribers.end());
+
+        if (subscribers.empty())
+        {
+            _channels.erase(channel);
+            last = true;
+        }
+        Metrics::setGauge(Gauge::PublicChannels, static_cast<int64_t>(_channels.size()));
+    }
+
+    if (last)
+    {
+        boost::asio::post(_strand, [this, channel = std::move(channel)]() {
+            if (_connected)
+            {
+                sendSubscription("public/unsubscribe", {channel});
+            }
+        });
+    }
+}
+
+size_t PublicMarketDataFeed::channelCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _channels.size();
+}
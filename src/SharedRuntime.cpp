@@ -0,0 +1,78 @@
+#include "SharedRuntime.hpp"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+SharedRuntime::SharedRuntime(const std::string& host, const std::string& port, size_t threads)
+    : _host(host), _port(port),
+      _threadCount(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      _io_context(static_cast<int>(_threadCount)),
+      _work(boost::asio::make_work_guard(_io_context)),
+      _ssl_context(boost::asio::ssl::context::tls_client)
+{
+    _ssl_context.set_options(
+        boost::asio::ssl::context::default_workarounds |
+        boost::asio::ssl::context::no_sslv2 |
+        boost::asio::ssl::context::no_sslv3 |
+        boost::asio::ssl::context::no_tlsv1 |
+        boost::asio::ssl::context::no_tlsv1_1
+    );
+    _ssl_context.set_default_verify_paths();
+    _ssl_context.set_verify_mode(boost::asio::ssl::verify_peer);
+    _ssl_context.set_verify_callback(boost::asio::ssl::host_name_verification(_host));
+    _sessionCache.attach(_ssl_context);
+
+    _marketData = std::make_unique<PublicMarketDataFeed>(_io_context, _ssl_context, _sessionCache, _host, _port);
+}
+
+SharedRuntime::~SharedRuntime()
+{
+    stop();
+}
+
+void SharedRuntime::start()
+{
+    if (!_threads.empty())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < _threadCount; ++i)
+    {
+        _threads.emplace_back([this]() {
+            try
+            {
+                _io_context.run();
+            }
+            catch (const std::exception& ex)
+            {
+                spdlog::error("Shared runtime io thread error: {}", ex.what());
+            }
+        });
+    }
+
+    _marketData->start();
+    spdlog::info("Shared runtime started with {} io threads for {}:{}", _threadCount, _host, _port);
+}
+
+void SharedRuntime::stop()
+{
+    if (_threads.empty())
+    {
+        return;
+    }
+
+    _marketData->stop();
+    _work.reset();
+    _io_context.stop();
+
+    for (auto& thread : _threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    _threads.clear();
+
+    spdlog::info("Shared runtime stopped.");
+}
@@ -0,0 +1,160 @@
+#include "ShmBookPublisher.hpp"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <spdlog/spdlog.h>
+
+ShmBookPublisher::ShmBookPublisher(const std::string& segment_name, size_t max_instruments)
+    : _segmentName(segment_name), _maxInstruments(max_instruments), _segmentSize(shmBookSegmentSize(max_instruments)), _fd(-1), _base(nullptr), _header(nullptr), _slots(nullptr)
+{
+    // Never reuse an existing segment in place: wiping it would corrupt the
+    // books under its readers. A stale one is retired and recreated instead.
+    uint64_t generation = 1;
+    _fd = shm_open(_segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (_fd < 0 && errno == EEXIST)
+    {
+        generation = retireStaleSegment() + 1;
+        _fd = shm_open(_segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+
+    if (_fd < 0)
+    {
+        spdlog::error("shm_open({}) failed: {}", _segmentName, std::strerror(errno));
+        throw std::runtime_error("Unable to open shared-memory segment");
+    }
+
+    if (ftruncate(_fd, static_cast<off_t>(_segmentSize)) != 0)
+    {
+        spdlog::error("ftruncate({}) failed: {}", _segmentName, std::strerror(errno));
+        close(_fd);
+        shm_unlink(_segmentName.c_str());
+        throw std::runtime_error("Unable to size shared-memory segment");
+    }
+
+    _base = mmap(nullptr, _segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (_base == MAP_FAILED)
+    {
+        spdlog::error("mmap({}) failed: {}", _segmentName, std::strerror(errno));
+        close(_fd);
+        shm_unlink(_segmentName.c_str());
+        throw std::runtime_error("Unable to map shared-memory segment");
+    }
+
+    std::memset(_base, 0, _segmentSize);
+    _header = new (_base) ShmBookHeader();
+    _slots = shmBookSlots(_base);
+    for (size_t i = 0; i < _maxInstruments; ++i)
+    {
+        new (&_slots[i]) ShmBookSlot();
+    }
+
+    _header->version = ShmBookHeader::layout_version;
+    _header->max_instruments = static_cast<uint32_t>(_maxInstruments);
+    _header->depth = static_cast<uint32_t>(BookTop::max_depth);
+    _header->slot_size = static_cast<uint32_t>(sizeof(ShmBookSlot));
+    _header->publisher_pid = static_cast<int32_t>(getpid());
+    _header->generation.store(generation, std::memory_order_relaxed);
+    _header->instrument_count.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = ShmBookHeader::magic_value;
+
+    spdlog::info("Publishing books to shared memory segment {} ({} bytes, generation {})", _segmentName, _segmentSize, generation);
+}
+
+uint64_t ShmBookPublisher::retireStaleSegment()
+{
+    uint64_t generation = 0;
+
+    int fd = shm_open(_segmentName.c_str(), O_RDWR, 0);
+    if (fd >= 0)
+    {
+        struct stat info;
+        void* base = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(ShmBookHeader))
+        {
+            base = mmap(nullptr, sizeof(ShmBookHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+
+        if (base != MAP_FAILED)
+        {
+            auto* header = static_cast<ShmBookHeader*>(base);
+            if (header->magic == ShmBookHeader::magic_value && header->version == ShmBookHeader::layout_version)
+            {
+                pid_t owner = static_cast<pid_t>(header->publisher_pid);
+                if (owner > 0 && (kill(owner, 0) == 0 || errno == EPERM))
+                {
+                    munmap(base, sizeof(ShmBookHeader));
+                    spdlog::error("Shared memory segment {} is already published by process {}", _segmentName, owner);
+                    throw std::runtime_error("Shared-memory segment is owned by a live publisher");
+                }
+
+                // Tell readers still mapping the old segment to reopen.
+                generation = header->generation.fetch_add(1, std::memory_order_release) + 1;
+            }
+            munmap(base, sizeof(ShmBookHeader));
+        }
+    }
+
+    spdlog::warn("Replacing stale shared memory segment {}", _segmentName);
+    shm_unlink(_segmentName.c_str());
+    return generation;
+}
+
+ShmBookPublisher::~ShmBookPublisher()
+{
+    if (_base && _base != MAP_FAILED)
+    {
+        _header->generation.fetch_add(1, std::memory_order_release);
+        munmap(_base, _segmentSize);
+    }
+
+    if (_fd >= 0)
+    {
+        close(_fd);
+        shm_unlink(_segmentName.c_str());
+    }
+}
+
+int ShmBookPublisher::registerInstrument(const std::string& instrument_name)
+{
+    auto it = _instrumentIndex.find(instrument_name);
+    if (it != _instrumentIndex.end())
+    {
+        return it->second;
+    }
+
+    uint32_t index = _header->instrument_count.load(std::memory_order_relaxed);
+    if (index >= _maxInstruments)
+    {
+        spdlog::warn("Shared memory segment {} is full. {} will not be published.", _segmentName, instrument_name);
+        return -1;
+    }
+
+    if (instrument_name.size() >= ShmBookSlot::max_name_length)
+    {
+        spdlog::warn("Instrument name {} is too long for shared memory publishing.", instrument_name);
+        return -1;
+    }
+
+    std::memcpy(_slots[index].instrument_name, instrument_name.c_str(), instrument_name.size() + 1);
+    _header->instrument_count.store(index + 1, std::memory_order_release);
+    _instrumentIndex.emplace(instrument_name, static_cast<int>(index));
+    return static_cast<int>(index);
+}
+
+void ShmBookPublisher::publishBook(int slot, const BookTop& top)
+{
+    _slots[slot].book.store(top);
+}
+
+void ShmBookPublisher::publishTrade(int slot, const Trade& trade)
+{
+    _slots[slot].last_trade.store(trade);
+}
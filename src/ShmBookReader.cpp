@@ -0,0 +1,109 @@
+#include "ShmBookReader.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ShmBookReader::ShmBookReader(const std::string& segment_name)
+    : _segmentSize(0), _generation(0), _base(nullptr), _header(nullptr), _slots(nullptr)
+{
+    int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to open shared-memory segment " + segment_name + ": " + std::strerror(errno));
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmBookHeader))
+    {
+        close(fd);
+        throw std::runtime_error("Shared-memory segment " + segment_name + " is not initialised");
+    }
+
+    _segmentSize = static_cast<size_t>(info.st_size);
+    _base = mmap(nullptr, _segmentSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (_base == MAP_FAILED)
+    {
+        _base = nullptr;
+        throw std::runtime_error("Unable to map shared-memory segment " + segment_name + ": " + std::strerror(errno));
+    }
+
+    _header = static_cast<const ShmBookHeader*>(_base);
+    if (_header->magic != ShmBookHeader::magic_value ||
+        _header->version != ShmBookHeader::layout_version ||
+        _header->slot_size != sizeof(ShmBookSlot) ||
+        _segmentSize < shmBookSegmentSize(_header->max_instruments))
+    {
+        munmap(_base, _segmentSize);
+        _base = nullptr;
+        throw std::runtime_error("Shared-memory segment " + segment_name + " has an incompatible layout");
+    }
+
+    _generation = _header->generation.load(std::memory_order_acquire);
+    _slots = shmBookSlots(_base);
+}
+
+ShmBookReader::~ShmBookReader()
+{
+    if (_base)
+    {
+        munmap(_base, _segmentSize);
+    }
+}
+
+size_t ShmBookReader::instrumentCount() const
+{
+    return _header->instrument_count.load(std::memory_order_acquire);
+}
+
+int ShmBookReader::findInstrument(const std::string& instrument_name) const
+{
+    size_t count = instrumentCount();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (std::strncmp(_slots[i].instrument_name, instrument_name.c_str(), ShmBookSlot::max_name_length) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ShmBookReader::stale() const
+{
+    return _header->generation.load(std::memory_order_acquire) != _generation;
+}
+
+const char* ShmBookReader::instrumentName(int slot) const
+{
+    if (slot < 0 || static_cast<size_t>(slot) >= instrumentCount())
+    {
+        return nullptr;
+    }
+    return _slots[slot].instrument_name;
+}
+
+bool ShmBookReader::readBook(int slot, BookTop& out) const
+{
+    if (slot < 0 || static_cast<size_t>(slot) >= instrumentCount())
+    {
+        return false;
+    }
+
+    return _slots[slot].book.tryLoad(out, max_read_attempts);
+}
+
+bool ShmBookReader::readTrade(int slot, Trade& out) const
+{
+    if (slot < 0 || static_cast<size_t>(slot) >= instrumentCount())
+    {
+        return false;
+    }
+
+    return _slots[slot].last_trade.tryLoad(out, max_read_attempts);
+}
@@ -0,0 +1,184 @@
+#include "StartupOrchestrator.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+    const char* stateName(StartupOrchestrator::State state)
+    {
+        switch (state)
+        {
+            case StartupOrchestrator::State::Pending: return "pending";
+            case StartupOrchestrator::State::Running: return "running";
+            case StartupOrchestrator::State::Done: return "done";
+            case StartupOrchestrator::State::Failed: return "FAILED";
+            case StartupOrchestrator::State::Skipped: return "skipped";
+        }
+        return "unknown";
+    }
+
+    double milliseconds(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+void StartupOrchestrator::addPhase(const std::string& name, std::function<void()> run, const std::vector<std::string>& dependencies)
+{
+    Phase phase;
+    phase.name = name;
+    phase.run = std::move(run);
+
+    for (const auto& dependency : dependencies)
+    {
+        size_t index = 0;
+        while (index < _phases.size() && _phases[index].name != dependency)
+        {
+            ++index;
+        }
+
+        if (index == _phases.size())
+        {
+            throw std::invalid_argument("Startup phase " + name + " depends on unknown phase " + dependency);
+        }
+        phase.dependencies.push_back(index);
+    }
+
+    _phases.push_back(std::move(phase));
+}
+
+void StartupOrchestrator::run()
+{
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::thread> threads;
+    size_t running = 0;
+    std::string failure;
+
+    _started = std::chrono::steady_clock::now();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            for (size_t i = 0; i < _phases.size(); ++i)
+            {
+                Phase& phase = _phases[i];
+                if (phase.state != State::Pending)
+                {
+                    continue;
+                }
+
+                if (!failure.empty())
+                {
+                    phase.state = State::Skipped;
+                    continue;
+                }
+
+                bool ready = true;
+                for (size_t dependency : phase.dependencies)
+                {
+                    ready = ready && _phases[dependency].state == State::Done;
+                }
+
+                if (!ready)
+                {
+                    continue;
+                }
+
+                phase.state = State::Running;
+                phase.started = std::chrono::steady_clock::now();
+                ++running;
+
+                threads.emplace_back([this, i, &mutex, &finished, &running, &failure]() {
+                    std::string error;
+                    try
+                    {
+                        _phases[i].run();
+                    }
+                    catch (const std::exception& ex)
+                    {
+                        error = ex.what();
+                    }
+                    catch (...)
+                    {
+                        error = "unknown error";
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    Phase& phase = _phases[i];
+                    phase.finished = std::chrono::steady_clock::now();
+                    phase.state = error.empty() ? State::Done : State::Failed;
+                    phase.error = std::move(error);
+
+                    if (phase.state == State::Failed && failure.empty())
+                    {
+                        failure = phase.name + ": " + phase.error;
+                    }
+
+                    --running;
+                    finished.notify_all();
+                });
+            }
+
+            if (running == 0)
+            {
+                break;
+            }
+
+            finished.wait(lock);
+        }
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    _finished = std::chrono::steady_clock::now();
+    report();
+
+    if (!failure.empty())
+    {
+        throw std::runtime_error("Startup failed in " + failure);
+    }
+}
+
+std::vector<StartupOrchestrator::PhaseTiming> StartupOrchestrator::timings() const
+{
+    std::vector<PhaseTiming> result;
+    result.reserve(_phases.size());
+
+    for (const auto& phase : _phases)
+    {
+        bool ran = phase.state == State::Done || phase.state == State::Failed;
+        result.push_back({
+            phase.name,
+            phase.state,
+            ran ? std::chrono::nanoseconds(phase.started - _started) : std::chrono::nanoseconds(0),
+            ran ? std::chrono::nanoseconds(phase.finished - phase.started) : std::chrono::nanoseconds(0),
+            phase.error
+        });
+    }
+
+    return result;
+}
+
+void StartupOrchestrator::report() const
+{
+    std::chrono::nanoseconds work(0);
+    auto phases = timings();
+
+    for (const auto& phase : phases)
+    {
+        work += phase.duration;
+        spdlog::info("Startup phase {:<14} {:<8} at +{:8.1f} ms took {:8.1f} ms{}{}",
+            phase.name, stateName(phase.state), milliseconds(phase.started), milliseconds(phase.duration),
+            phase.error.empty() ? "" : " : ", phase.error);
+    }
+
+    spdlog::info("Startup took {:.1f} ms wall clock for {:.1f} ms of phase work.", milliseconds(elapsed()), milliseconds(work));
+}
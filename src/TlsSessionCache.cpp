@@ -0,0 +1,78 @@
+#include "TlsSessionCache.hpp"
+#include <stdexcept>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+    // Our own ex_data slot: asio keeps its verify callback in the SSL_CTX app
+    // data, so that slot must not be touched.
+    int cacheIndex()
+    {
+        static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+}
+
+TlsSessionCache::~TlsSessionCache()
+{
+    for (auto& [host, session] : _sessions)
+    {
+        SSL_SESSION_free(session);
+    }
+}
+
+void TlsSessionCache::attach(boost::asio::ssl::context& context)
+{
+    SSL_CTX* native = context.native_handle();
+    if (cacheIndex() < 0 || !SSL_CTX_set_ex_data(native, cacheIndex(), this))
+    {
+        throw std::runtime_error("Failed to attach the TLS session cache to the SSL context");
+    }
+
+    SSL_CTX_set_session_cache_mode(native, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(native, &TlsSessionCache::onNewSession);
+}
+
+int TlsSessionCache::onNewSession(SSL* ssl, SSL_SESSION* session)
+{
+    auto* cache = static_cast<TlsSessionCache*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), cacheIndex()));
+    const char* host = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    if (!cache || !host)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(cache->_mutex);
+    SSL_SESSION*& slot = cache->_sessions[host];
+    if (slot)
+    {
+        SSL_SESSION_free(slot);
+    }
+
+    // Returning 1 hands our reference to the cache.
+    slot = session;
+    spdlog::debug("Cached TLS session for {}", host);
+    return 1;
+}
+
+void TlsSessionCache::resume(SSL* ssl)
+{
+    const char* host = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    if (!host)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _sessions.find(host);
+    if (it != _sessions.end() && SSL_SESSION_is_resumable(it->second))
+    {
+        SSL_set_session(ssl, it->second);
+    }
+}
+
+size_t TlsSessionCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _sessions.size();
+}
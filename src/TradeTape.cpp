@@ -0,0 +1,256 @@
+#include "TradeTape.hpp"
+#include <spdlog/spdlog.h>
+
+namespace
+{
+    size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Four independent accumulators per sum keep the loop free of a serial
+    // floating-point dependency, so the compiler can vectorise it without
+    // -ffast-math.
+    void accumulate(const double* prices, const double* amounts, const int8_t* directions, size_t count,
+                    double& volume, double& notional, double& buy_volume)
+    {
+        double v[4] = {0.0, 0.0, 0.0, 0.0};
+        double n[4] = {0.0, 0.0, 0.0, 0.0};
+        double b[4] = {0.0, 0.0, 0.0, 0.0};
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                double amount = amounts[i + lane];
+                v[lane] += amount;
+                n[lane] += prices[i + lane] * amount;
+                b[lane] += static_cast<double>(directions[i + lane] > 0) * amount;
+            }
+        }
+
+        for (; i < count; ++i)
+        {
+            v[0] += amounts[i];
+            n[0] += prices[i] * amounts[i];
+            b[0] += static_cast<double>(directions[i] > 0) * amounts[i];
+        }
+
+        volume += (v[0] + v[1]) + (v[2] + v[3]);
+        notional += (n[0] + n[1]) + (n[2] + n[3]);
+        buy_volume += (b[0] + b[1]) + (b[2] + b[3]);
+    }
+}
+
+TradeTape::Ring::Ring(size_t capacity)
+    : timestamps(capacity), prices(capacity), amounts(capacity), directions(capacity), trade_ids(capacity)
+{
+}
+
+TradeTape::TradeTape(size_t capacity_per_instrument)
+    : _capacity(roundUpToPowerOfTwo(std::max<size_t>(capacity_per_instrument, 2))), _mask(_capacity - 1)
+{
+}
+
+int TradeTape::registerInstrument(const std::string& instrument_name)
+{
+    std::unique_lock<std::shared_mutex> lock(_registrationMutex);
+
+    auto it = _instrumentIndex.find(instrument_name);
+    if (it != _instrumentIndex.end())
+    {
+        return static_cast<int>(it->second);
+    }
+
+    size_t index = _ringCount.load(std::memory_order_relaxed);
+    if (index >= max_instruments)
+    {
+        spdlog::warn("Trade tape is full ({} instruments). {} will not be recorded.", max_instruments, instrument_name);
+        return -1;
+    }
+
+    _rings[index] = std::make_unique<Ring>(_capacity);
+    _ringCount.store(index + 1, std::memory_order_release);
+    _instrumentIndex.emplace(instrument_name, index);
+    return static_cast<int>(index);
+}
+
+int TradeTape::findInstrument(const std::string& instrument_name) const
+{
+    std::shared_lock<std::shared_mutex> lock(_registrationMutex);
+
+    auto it = _instrumentIndex.find(instrument_name);
+    return it == _instrumentIndex.end() ? -1 : static_cast<int>(it->second);
+}
+
+const TradeTape::Ring* TradeTape::ring(int instrument) const
+{
+    if (instrument < 0 || static_cast<size_t>(instrument) >= _ringCount.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    return _rings[instrument].get();
+}
+
+void TradeTape::append(int instrument, const Trade& trade)
+{
+    Ring* target = const_cast<Ring*>(ring(instrument));
+    if (!target)
+    {
+        return;
+    }
+
+    uint64_t head = target->head.load(std::memory_order_relaxed);
+    // Orders the previous head store before the overwrite below, as in SeqLock::store.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t slot = static_cast<size_t>(head) & _mask;
+    target->timestamps[slot] = trade.timestamp;
+    target->prices[slot] = trade.price;
+    target->amounts[slot] = trade.amount;
+    target->directions[slot] = trade.direction;
+    target->trade_ids[slot] = trade.trade_id;
+    target->head.store(head + 1, std::memory_order_release);
+}
+
+uint64_t TradeTape::oldest(uint64_t head) const
+{
+    // The slot after the head may be mid-overwrite, so one slot is never exposed.
+    return head >= _capacity ? head - (_capacity - 1) : 0;
+}
+
+size_t TradeTape::size(int instrument) const
+{
+    const Ring* source = ring(instrument);
+    if (!source)
+    {
+        return 0;
+    }
+
+    uint64_t head = source->head.load(std::memory_order_acquire);
+    return static_cast<size_t>(head - oldest(head));
+}
+
+void TradeTape::range(const Ring& ring, uint64_t head, int64_t from, int64_t to, uint64_t& first, uint64_t& last) const
+{
+    const uint64_t start = oldest(head);
+
+    auto lowerBound = [&](int64_t timestamp) {
+        uint64_t lo = start;
+        uint64_t hi = head;
+        while (lo < hi)
+        {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (ring.timestamps[static_cast<size_t>(mid) & _mask] < timestamp)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    };
+
+    first = lowerBound(from);
+    last = std::max(first, lowerBound(to));
+}
+
+bool TradeTape::stillValid(const Ring& ring, uint64_t first) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return first >= oldest(ring.head.load(std::memory_order_relaxed));
+}
+
+size_t TradeTape::query(int instrument, int64_t from, int64_t to, std::vector<Trade>& out) const
+{
+    out.clear();
+
+    const Ring* source = ring(instrument);
+    if (!source)
+    {
+        return 0;
+    }
+
+    for (int attempt = 0; attempt < max_read_attempts; ++attempt)
+    {
+        out.clear();
+
+        uint64_t first, last;
+        range(*source, source->head.load(std::memory_order_acquire), from, to, first, last);
+        out.reserve(static_cast<size_t>(last - first));
+
+        for (uint64_t i = first; i < last; ++i)
+        {
+            size_t slot = static_cast<size_t>(i) & _mask;
+            out.push_back({source->timestamps[slot], source->prices[slot], source->amounts[slot], source->directions[slot], source->trade_ids[slot]});
+        }
+
+        if (stillValid(*source, first))
+        {
+            return out.size();
+        }
+    }
+
+    // The writer kept lapping the window; report nothing rather than torn data.
+    out.clear();
+    return 0;
+}
+
+TradeTape::Aggregates TradeTape::aggregate(int instrument, int64_t from, int64_t to) const
+{
+    const Ring* source = ring(instrument);
+    if (!source)
+    {
+        return Aggregates();
+    }
+
+    for (int attempt = 0; attempt < max_read_attempts; ++attempt)
+    {
+        Aggregates result;
+
+        uint64_t first, last;
+        range(*source, source->head.load(std::memory_order_acquire), from, to, first, last);
+        result.trades = static_cast<size_t>(last - first);
+        if (result.trades == 0)
+        {
+            return result;
+        }
+
+        // The window is at most two contiguous runs of the ring.
+        size_t begin = static_cast<size_t>(first) & _mask;
+        size_t firstRun = std::min(result.trades, _capacity - begin);
+
+        accumulate(&source->prices[begin], &source->amounts[begin], &source->directions[begin], firstRun,
+                   result.volume, result.notional, result.buy_volume);
+
+        if (firstRun < result.trades)
+        {
+            accumulate(&source->prices[0], &source->amounts[0], &source->directions[0], result.trades - firstRun,
+                       result.volume, result.notional, result.buy_volume);
+        }
+
+        if (!stillValid(*source, first))
+        {
+            continue;
+        }
+
+        result.sell_volume = result.volume - result.buy_volume;
+        if (result.volume > 0.0)
+        {
+            result.vwap = result.notional / result.volume;
+            result.imbalance = (result.buy_volume - result.sell_volume) / result.volume;
+        }
+
+        return result;
+    }
+
+    return Aggregates();
+}
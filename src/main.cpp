@@ -1,5 +1,8 @@
 #include "Client.hpp"
+#include "Metrics.hpp"
+#include "StartupOrchestrator.hpp"
 #include "spdlog/sinks/basic_file_sink.h"
+#include <limits>
 
 // void setup_logging() 
 // {
@@ -19,6 +22,9 @@
 
 constexpr const char* clientId = "";
 constexpr const char* clientSecret = "";
+constexpr unsigned short metricsPort = 9185;
+constexpr bool paperTrading = false;
+constexpr const char* startupCurrency = "BTC";
 
 const nlohmann::json Client::payload = {
     {"jsonrpc", "2.0"},
@@ -38,26 +44,48 @@ int main()
     auto start = std::chrono::high_resolution_clock::now();
     int choice;
 
+    std::unique_ptr<MetricsServer> metricsServer;
+    try
+    {
+        metricsServer = std::make_unique<MetricsServer>(metricsPort);
+        metricsServer->start();
+    }
+    catch (const std::exception& e)
+    {
+        spdlog::warn("Metrics endpoint disabled: {}", e.what());
+    }
+
     Client client("test.deribit.com", "443", clientId, clientSecret);
+    client.enableSharedMemoryPublisher("/derbit_books");
 
-    try
+    if (paperTrading)
     {
-        client.connect();
-        client.loadOrderHistory();
-        nlohmann::json response = client.sendRequest("/api/v2/public/auth", "POST ", client.payload);
+        client.enablePaperTrading(std::make_shared<PaperExchange>());
+    }
 
-        if (response.contains("result") && response["result"].contains("access_token")) 
-        {
-            std::string accessToken = response["result"]["access_token"];
-            client.setAccessToken(accessToken);
-            spdlog::info("Authenticated successfully. Access token: {}", accessToken);
-        }
+    StartupOrchestrator startup;
+    startup.addPhase("dns", [&]() { client.resolve(); });
+    startup.addPhase("history", [&]() { client.loadOrderHistory(); });
+    startup.addPhase("rest_connect", [&]() { client.connect(); }, {"dns"});
+    startup.addPhase("ws_connect", [&]() { client.connectWebSocket(); }, {"dns"});
+    startup.addPhase("rest_auth", [&]() { client.authenticate(); }, {"rest_connect"});
+    startup.addPhase("ws_auth", [&]() { client.authenticateWebSocket(); }, {"ws_connect"});
+    startup.addPhase("instruments", [&]() { client.loadInstruments(startupCurrency); }, {"rest_connect"});
+
+    try
+    {
+        startup.run();
     }
     catch(const std::exception& e)
     {
-        spdlog::info("Something goes wrong : {}", e.what());
+        spdlog::error("{}. Exiting.", e.what());
+        return 1;
     }
 
+    // Only now is the REST session connected and authenticated, so the ping
+    // thread's reconnects cannot race the startup phases.
+    client.startPing();
+
     while (true) 
     {
         client.printMenu();
@@ -131,8 +159,25 @@ int main()
                     }
                     auto startTimestamp = std::chrono::high_resolution_clock::now();
                     client.subscribeToMarketData(symbol);
+                    client.subscribeToTrades(symbol);
                     client.streamMarketData(seconds);
 
+                    TradeTape& tape = client.tradeTape();
+                    int tapeSlot = tape.findInstrument(symbol);
+                    if (tapeSlot >= 0)
+                    {
+                        auto stats = tape.aggregate(tapeSlot, 0, std::numeric_limits<int64_t>::max());
+                        spdlog::info("Trades: {}, volume: {}, VWAP: {:.2f}, buy/sell imbalance: {:.3f}", stats.trades, stats.volume, stats.vwap, stats.imbalance);
+                    }
+
+                    BookMetrics metrics;
+                    int analyticsSlot = client.analytics().findInstrument(symbol);
+                    if (analyticsSlot >= 0 && client.analytics().snapshot(analyticsSlot, metrics))
+                    {
+                        spdlog::info("Spread: {}, mid: {}, microprice: {:.2f}, depth imbalance: {:.3f}, book pressure: {:.3f}",
+                            metrics.spread, metrics.mid, metrics.microprice, metrics.depth_imbalance, metrics.book_pressure);
+                    }
+
                     auto endTimestamp = std::chrono::high_resolution_clock::now();
                     auto elapsed_time = endTimestamp - startTimestamp;
                     spdlog::info("Market data streaming end to end latency : {}", elapsed_time.count());
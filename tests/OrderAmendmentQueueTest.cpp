@@ -0,0 +1,218 @@
+#include "OrderAmendmentQueue.hpp"
+#include <gtest/gtest.h>
+#include <deque>
+
+using json = nlohmann::json;
+
+namespace
+{
+    // Records what the queue sends and lets the test complete requests in order.
+    struct FakeVenue {
+        struct Sent {
+            std::string action;
+            std::string order_id;
+            double amount;
+            double price;
+            OrderAmendmentQueue::Completion completion;
+        };
+
+        std::deque<Sent> inFlight;
+        std::vector<Sent> history;
+
+        OrderAmendmentQueue makeQueue()
+        {
+            return OrderAmendmentQueue(
+                [this](const std::string& order_id, double amount, double price, OrderAmendmentQueue::Completion completion) {
+                    record({"edit", order_id, amount, price, std::move(completion)});
+                },
+                [this](const std::string& order_id, OrderAmendmentQueue::Completion completion) {
+                    record({"cancel", order_id, 0.0, 0.0, std::move(completion)});
+                });
+        }
+
+        void record(Sent sent)
+        {
+            history.push_back({sent.action, sent.order_id, sent.amount, sent.price, nullptr});
+            inFlight.push_back(std::move(sent));
+        }
+
+        void succeed()
+        {
+            Sent sent = std::move(inFlight.front());
+            inFlight.pop_front();
+            sent.completion(boost::system::error_code(), {{"result", json::object()}});
+        }
+
+        void fail()
+        {
+            Sent sent = std::move(inFlight.front());
+            inFlight.pop_front();
+            sent.completion(boost::system::error_code(), {{"error", {{"code", 10009}}}});
+        }
+    };
+}
+
+TEST(OrderAmendmentQueueTest, FirstAmendmentIsSentImmediately)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.amend("42", 10.0, 100.0);
+
+    ASSERT_EQ(venue.history.size(), 1u);
+    EXPECT_EQ(venue.history[0].action, "edit");
+    EXPECT_DOUBLE_EQ(venue.history[0].price, 100.0);
+    EXPECT_EQ(queue.trackedOrders(), 1u);
+
+    venue.succeed();
+    EXPECT_EQ(queue.trackedOrders(), 0u);
+}
+
+TEST(OrderAmendmentQueueTest, EditsBehindAnInFlightEditCollapseToTheLatest)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.amend("42", 10.0, 100.0);
+    queue.amend("42", 10.0, 101.0);
+    queue.amend("42", 12.0, 102.0);
+
+    ASSERT_EQ(venue.history.size(), 1u) << "only one request may be in flight per order";
+
+    venue.succeed();
+
+    ASSERT_EQ(venue.history.size(), 2u);
+    EXPECT_EQ(venue.history[1].action, "edit");
+    EXPECT_DOUBLE_EQ(venue.history[1].amount, 12.0);
+    EXPECT_DOUBLE_EQ(venue.history[1].price, 102.0);
+
+    venue.succeed();
+    EXPECT_EQ(venue.history.size(), 2u);
+    EXPECT_EQ(queue.trackedOrders(), 0u);
+}
+
+TEST(OrderAmendmentQueueTest, CancelBehindAnInFlightEditSupersedesQueuedEdits)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.amend("42", 10.0, 100.0);
+    queue.amend("42", 10.0, 101.0);
+    queue.cancel("42");
+
+    venue.succeed();
+
+    ASSERT_EQ(venue.history.size(), 2u);
+    EXPECT_EQ(venue.history[1].action, "cancel");
+
+    venue.succeed();
+    EXPECT_EQ(venue.history.size(), 2u);
+}
+
+TEST(OrderAmendmentQueueTest, AmendmentsAfterACancelAreDropped)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.amend("42", 10.0, 100.0);
+    queue.cancel("42");
+    queue.amend("42", 10.0, 105.0);
+    queue.cancel("42");
+
+    venue.succeed();
+    venue.succeed();
+
+    ASSERT_EQ(venue.history.size(), 2u);
+    EXPECT_EQ(venue.history[0].action, "edit");
+    EXPECT_EQ(venue.history[1].action, "cancel");
+}
+
+TEST(OrderAmendmentQueueTest, AmendmentsAfterAConfirmedCancelAreDropped)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.cancel("42");
+    venue.succeed();
+    EXPECT_EQ(queue.trackedOrders(), 0u);
+
+    queue.amend("42", 10.0, 100.0);
+    queue.cancel("42");
+
+    ASSERT_EQ(venue.history.size(), 1u);
+    EXPECT_EQ(venue.history[0].action, "cancel");
+    EXPECT_TRUE(venue.inFlight.empty());
+}
+
+TEST(OrderAmendmentQueueTest, CancelledOrderMemoryIsBounded)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    for (size_t i = 0; i <= OrderAmendmentQueue::max_cancelled; ++i)
+    {
+        queue.cancel(std::to_string(i));
+        venue.succeed();
+    }
+
+    // The oldest cancelled id has been forgotten; the newest is still remembered.
+    queue.amend("0", 10.0, 100.0);
+    queue.amend(std::to_string(OrderAmendmentQueue::max_cancelled), 10.0, 100.0);
+
+    ASSERT_EQ(venue.history.size(), OrderAmendmentQueue::max_cancelled + 2);
+    EXPECT_EQ(venue.history.back().action, "edit");
+    EXPECT_EQ(venue.history.back().order_id, "0");
+}
+
+TEST(OrderAmendmentQueueTest, RejectedCancelLetsLaterAmendmentsThrough)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.cancel("42");
+    queue.amend("42", 10.0, 100.0);
+    venue.fail();
+
+    queue.amend("42", 10.0, 101.0);
+
+    ASSERT_EQ(venue.history.size(), 2u);
+    EXPECT_EQ(venue.history[1].action, "edit");
+    EXPECT_DOUBLE_EQ(venue.history[1].price, 101.0);
+}
+
+TEST(OrderAmendmentQueueTest, OrdersAreIndependent)
+{
+    FakeVenue venue;
+    OrderAmendmentQueue queue = venue.makeQueue();
+
+    queue.amend("1", 10.0, 100.0);
+    queue.amend("2", 10.0, 200.0);
+
+    ASSERT_EQ(venue.history.size(), 2u);
+    EXPECT_EQ(venue.history[0].order_id, "1");
+    EXPECT_EQ(venue.history[1].order_id, "2");
+}
+
+TEST(OrderAmendmentQueueTest, SynchronousCompletionDispatchesTheNextAmendment)
+{
+    // Paper trading completes requests inside the sender.
+    std::vector<double> sentPrices;
+    OrderAmendmentQueue* self = nullptr;
+    OrderAmendmentQueue queue(
+        [&](const std::string& order_id, double, double price, OrderAmendmentQueue::Completion completion) {
+            sentPrices.push_back(price);
+            if (sentPrices.size() == 1)
+            {
+                self->amend(order_id, 10.0, 101.0);
+            }
+            completion(boost::system::error_code(), {{"result", json::object()}});
+        },
+        [](const std::string&, OrderAmendmentQueue::Completion) {});
+    self = &queue;
+
+    queue.amend("42", 10.0, 100.0);
+
+    ASSERT_EQ(sentPrices.size(), 2u);
+    EXPECT_DOUBLE_EQ(sentPrices[1], 101.0);
+    EXPECT_EQ(queue.trackedOrders(), 0u);
+}
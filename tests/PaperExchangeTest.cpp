@@ -0,0 +1,101 @@
+#include "PaperExchange.hpp"
+#include <gtest/gtest.h>
+
+using json = nlohmann::json;
+
+namespace
+{
+    const char* instrument = "BTC-PERPETUAL";
+
+    BookUpdate level(double bid, double bid_amount, double ask, double ask_amount)
+    {
+        BookUpdate update;
+        update.instrument_name = instrument;
+        update.timestamp = 1;
+        update.is_snapshot = true;
+        update.bids.push_back({BookLevelChange::Action::New, bid, bid_amount});
+        update.asks.push_back({BookLevelChange::Action::New, ask, ask_amount});
+        return update;
+    }
+
+    std::string buy(PaperExchange& exchange, double amount, double price)
+    {
+        json response = exchange.handleRequest({
+            {"id", 1},
+            {"method", "private/buy"},
+            {"params", {{"instrument_name", instrument}, {"amount", amount}, {"price", price}, {"type", "limit"}}}
+        });
+        return response.at("result").at("order").at("order_id").get<std::string>();
+    }
+
+    double filled(const PaperExchange& exchange, const std::string& order_id)
+    {
+        for (const auto& order : exchange.openOrders(instrument))
+        {
+            if (order["order_id"] == order_id)
+            {
+                return order["filled_amount"].get<double>();
+            }
+        }
+        return -1.0;
+    }
+
+    Trade sellPrint(double price, double amount)
+    {
+        return {2, price, amount, Trade::Sell, 1};
+    }
+}
+
+TEST(PaperExchangeTest, PrintLiquidityIsSharedAcrossOrdersAtOneLevel)
+{
+    PaperExchange exchange;
+    exchange.onBook(level(100.0, 5.0, 101.0, 5.0));
+
+    std::string first = buy(exchange, 2.0, 100.0);
+    std::string second = buy(exchange, 2.0, 100.0);
+
+    // 5 ahead of both orders, so only 1 of the 6 reaches the first order and none the second.
+    exchange.onTrade(instrument, sellPrint(100.0, 6.0));
+
+    EXPECT_DOUBLE_EQ(filled(exchange, first), 1.0);
+    EXPECT_DOUBLE_EQ(filled(exchange, second), 0.0);
+}
+
+TEST(PaperExchangeTest, BetterPricedOrdersFillBeforeTheQueueAtThePrint)
+{
+    PaperExchange exchange;
+    exchange.onBook(level(100.0, 5.0, 102.0, 5.0));
+
+    std::string inside = buy(exchange, 3.0, 101.0);
+    std::string atLevel = buy(exchange, 2.0, 100.0);
+
+    exchange.onTrade(instrument, sellPrint(100.0, 4.0));
+    EXPECT_DOUBLE_EQ(filled(exchange, atLevel), 0.0);
+    EXPECT_DOUBLE_EQ(filled(exchange, inside), -1.0) << "fully filled orders leave the open set";
+
+    // The remaining 1 of the print ate into the 5 ahead, leaving 4.
+    exchange.onTrade(instrument, sellPrint(100.0, 5.0));
+    EXPECT_DOUBLE_EQ(filled(exchange, atLevel), 1.0);
+}
+
+TEST(PaperExchangeTest, TradedSizeIsNotTreatedAsCancellation)
+{
+    PaperExchange exchange;
+    exchange.onBook(level(100.0, 5.0, 101.0, 5.0));
+    std::string order = buy(exchange, 1.0, 100.0);
+
+    exchange.onTrade(instrument, sellPrint(100.0, 2.0));
+
+    // The feed then shows the level down by exactly the traded size.
+    BookUpdate update;
+    update.instrument_name = instrument;
+    update.timestamp = 3;
+    update.bids.push_back({BookLevelChange::Action::Change, 100.0, 3.0});
+    exchange.onBook(update);
+
+    exchange.onTrade(instrument, sellPrint(100.0, 3.0));
+    EXPECT_DOUBLE_EQ(filled(exchange, order), 0.0);
+
+    exchange.onTrade(instrument, sellPrint(100.0, 0.5));
+    EXPECT_DOUBLE_EQ(filled(exchange, order), 0.5);
+}
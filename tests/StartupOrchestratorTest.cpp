@@ -0,0 +1,70 @@
+#include "StartupOrchestrator.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+    StartupOrchestrator::State stateOf(const StartupOrchestrator& startup, const std::string& name)
+    {
+        for (const auto& phase : startup.timings())
+        {
+            if (phase.name == name)
+            {
+                return phase.state;
+            }
+        }
+        return StartupOrchestrator::State::Pending;
+    }
+}
+
+TEST(StartupOrchestratorTest, RunsPhasesAfterTheirDependencies)
+{
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name) {
+        return [&, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    StartupOrchestrator startup;
+    startup.addPhase("dns", record("dns"));
+    startup.addPhase("connect", record("connect"), {"dns"});
+    startup.addPhase("auth", record("auth"), {"connect"});
+    startup.run();
+
+    EXPECT_EQ(order, (std::vector<std::string>{"dns", "connect", "auth"}));
+    EXPECT_EQ(stateOf(startup, "auth"), StartupOrchestrator::State::Done);
+}
+
+TEST(StartupOrchestratorTest, FailureNamesThePhaseAndSkipsDependents)
+{
+    std::atomic<bool> dependentRan{false};
+
+    StartupOrchestrator startup;
+    startup.addPhase("connect", []() { throw std::runtime_error("refused"); });
+    startup.addPhase("auth", [&]() { dependentRan = true; }, {"connect"});
+
+    try
+    {
+        startup.run();
+        FAIL() << "run() should rethrow the phase failure";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_EQ(std::string(e.what()), "Startup failed in connect: refused");
+    }
+
+    EXPECT_FALSE(dependentRan);
+    EXPECT_EQ(stateOf(startup, "connect"), StartupOrchestrator::State::Failed);
+    EXPECT_EQ(stateOf(startup, "auth"), StartupOrchestrator::State::Skipped);
+}
+
+TEST(StartupOrchestratorTest, RejectsUnknownDependencies)
+{
+    StartupOrchestrator startup;
+    EXPECT_THROW(startup.addPhase("auth", []() {}, {"connect"}), std::invalid_argument);
+}
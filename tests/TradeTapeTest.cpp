@@ -0,0 +1,63 @@
+#include "TradeTape.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+    Trade trade(int64_t timestamp, double price, double amount, Trade::Direction direction)
+    {
+        return {timestamp, price, amount, direction, static_cast<uint64_t>(timestamp)};
+    }
+}
+
+TEST(TradeTapeTest, AggregatesTradesInsideTheTimeRange)
+{
+    TradeTape tape(16);
+    int instrument = tape.registerInstrument("BTC-PERPETUAL");
+
+    tape.append(instrument, trade(1, 90.0, 5.0, Trade::Buy));
+    tape.append(instrument, trade(2, 100.0, 1.0, Trade::Buy));
+    tape.append(instrument, trade(3, 110.0, 3.0, Trade::Sell));
+    tape.append(instrument, trade(4, 120.0, 7.0, Trade::Sell));
+
+    TradeTape::Aggregates result = tape.aggregate(instrument, 2, 4);
+    EXPECT_EQ(result.trades, 2u);
+    EXPECT_DOUBLE_EQ(result.volume, 4.0);
+    EXPECT_DOUBLE_EQ(result.vwap, (100.0 * 1.0 + 110.0 * 3.0) / 4.0);
+    EXPECT_DOUBLE_EQ(result.imbalance, (1.0 - 3.0) / 4.0);
+
+    std::vector<Trade> trades;
+    ASSERT_EQ(tape.query(instrument, 2, 4, trades), 2u);
+    EXPECT_EQ(trades[0].trade_id, 2u);
+    EXPECT_EQ(trades[1].trade_id, 3u);
+}
+
+TEST(TradeTapeTest, WrappedRingKeepsTheNewestTrades)
+{
+    TradeTape tape(8);
+    int instrument = tape.registerInstrument("BTC-PERPETUAL");
+
+    for (int64_t timestamp = 1; timestamp <= 20; ++timestamp)
+    {
+        tape.append(instrument, trade(timestamp, 100.0, 1.0, Trade::Buy));
+    }
+
+    // One slot is never exposed because the writer may be overwriting it.
+    EXPECT_EQ(tape.size(instrument), tape.capacity() - 1);
+
+    std::vector<Trade> trades;
+    ASSERT_EQ(tape.query(instrument, 0, 100, trades), tape.capacity() - 1);
+    EXPECT_EQ(trades.front().timestamp, 14);
+    EXPECT_EQ(trades.back().timestamp, 20);
+    EXPECT_EQ(tape.aggregate(instrument, 0, 100).trades, tape.capacity() - 1);
+}
+
+TEST(TradeTapeTest, UnregisteredInstrumentsHaveNoRing)
+{
+    TradeTape tape(8);
+    int instrument = tape.registerInstrument("BTC-PERPETUAL");
+
+    EXPECT_EQ(tape.findInstrument("ETH-PERPETUAL"), -1);
+    tape.append(instrument + 1, trade(1, 100.0, 1.0, Trade::Buy));
+    EXPECT_EQ(tape.size(instrument + 1), 0u);
+    EXPECT_EQ(tape.aggregate(instrument + 1, 0, 100).trades, 0u);
+}